@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "core/arena.hpp"
+#include "core/autopilot.hpp"
+#include "core/batch_simulation.hpp"
+#include "core/fruit.hpp"
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+#include "core/random.hpp"
+#include "core/simulation.hpp"
+#include "core/snake.hpp"
+#include "core/state_pool.hpp"
+#include "core/thread_pool.hpp"
+
+namespace {
+    // A Hamiltonian cycle over any board with an even height: column 0 is
+    // the way back up, the other columns are swept row by row. A snake
+    // that follows it never collides, whatever its length.
+    direction_type cycle_direction(position_t const& t_pos,
+                                   int const t_width, int const t_height)
+    {
+        if(t_pos.j == 0) {
+            return t_pos.i > 0 ? UP : RIGHT;
+        }
+        if(t_pos.i % 2 == 0) {
+            return t_pos.j < t_width - 1 ? RIGHT : DOWN;
+        }
+        if(t_pos.j > 1) {
+            return LEFT;
+        }
+        return t_pos.i == t_height - 1 ? LEFT : DOWN;
+    }
+
+    template<typename Field>
+    direction_type next_step(Field const& t_field,
+                             snake_t<Field> const& t_snake)
+    {
+        return cycle_direction(t_snake.get_head_position(),
+                               t_field.width(), t_field.height());
+    }
+
+    // Grows t_snake along the cycle until it covers t_percent of the board.
+    template<typename Field>
+    void grow(Field& t_field, snake_t<Field>& t_snake,
+              std::int64_t const t_percent)
+    {
+        std::size_t const cells =
+            std::size_t(t_field.width()) * t_field.height();
+        std::size_t const target = std::max<std::size_t>(
+            1, cells * static_cast<std::size_t>(t_percent) / 100
+        );
+
+        while(t_snake.get_length() < target) {
+            t_snake.lengthen(t_field, next_step(t_field, t_snake));
+        }
+    }
+
+    template<typename Field>
+    Field make_field(int const t_size);
+
+    template<>
+    default_game_field_t make_field<default_game_field_t>(int const)
+    { return default_game_field_t{}; }
+    template<>
+    dynamic_game_field_t make_field<dynamic_game_field_t>(int const t_size)
+    { return dynamic_game_field_t{ dynamic_extent_t{ t_size, t_size } }; }
+    template<>
+    packed_game_field_t make_field<packed_game_field_t>(int const t_size)
+    { return packed_game_field_t{ dynamic_extent_t{ t_size, t_size } }; }
+
+    struct null_window_t
+    {
+        std::size_t cells{ 0 };
+
+        void clear_screen()
+        { cells = 0; }
+        void draw(position_t const&, field_base_t::cell_type const t_cell)
+        {
+            ++cells;
+            benchmark::DoNotOptimize(t_cell);
+        }
+    };
+}
+
+// snake_t::move along the cycle, at a given board size and fill level.
+template<typename Field>
+void BM_SnakeMove(benchmark::State& t_state)
+{
+    Field field{ make_field<Field>(static_cast<int>(t_state.range(0))) };
+    snake_t<Field> snake{ field };
+    grow(field, snake, t_state.range(1));
+
+    for(auto _ : t_state) {
+        snake.move(field, next_step(field, snake));
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations());
+}
+
+// snake_t::lengthen; the snake starts over once it fills the board.
+template<typename Field>
+void BM_SnakeLengthen(benchmark::State& t_state)
+{
+    int const size = static_cast<int>(t_state.range(0));
+    std::size_t const cells = std::size_t(size) * size;
+
+    Field field{ make_field<Field>(size) };
+    auto snake = std::make_unique<snake_t<Field>>(field);
+
+    for(auto _ : t_state) {
+        if(snake->get_length() == cells) {
+            t_state.PauseTiming();
+            field = make_field<Field>(size);
+            snake = std::make_unique<snake_t<Field>>(field);
+            t_state.ResumeTiming();
+        }
+
+        snake->lengthen(field, next_step(field, *snake));
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations());
+}
+
+// fruit_t::new_position on a board the snake already fills to range(1) %.
+template<typename Field>
+void BM_FruitNewPosition(benchmark::State& t_state)
+{
+    Field field{ make_field<Field>(static_cast<int>(t_state.range(0))) };
+    snake_t<Field> snake{ field };
+    grow(field, snake, t_state.range(1));
+
+    rng_engine_t rng{ 42 };
+    fruit_t<Field> fruit{ field, rng };
+
+    for(auto _ : t_state) {
+        position_t const old_position = fruit.get_position();
+        field.set(old_position.i, old_position.j, field_base_t::EMPTY);
+        benchmark::DoNotOptimize(fruit.new_position(field, rng));
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations());
+}
+
+// game_field_t::draw into a window that only counts the cells it gets.
+template<typename Field>
+void BM_FieldDraw(benchmark::State& t_state)
+{
+    Field field{ make_field<Field>(static_cast<int>(t_state.range(0))) };
+    snake_t<Field> snake{ field };
+    grow(field, snake, t_state.range(1));
+
+    null_window_t window{};
+
+    for(auto _ : t_state) {
+        field.draw(window);
+        benchmark::DoNotOptimize(window.cells);
+    }
+
+    t_state.SetItemsProcessed(
+        t_state.iterations() * field.width() * field.height()
+    );
+}
+
+// Whole simulation_t::step ticks, eating fruit as it comes; the game is
+// restarted once the snake fills the board.
+template<typename Field>
+void BM_SimulationStep(benchmark::State& t_state)
+{
+    int const size = static_cast<int>(t_state.range(0));
+    std::uint64_t seed{ 1 };
+
+    auto simulation =
+        std::make_unique<simulation_t<Field>>(seed, make_field<Field>(size));
+
+    for(auto _ : t_state) {
+        auto const& sim = *simulation;
+        direction_type const direction = cycle_direction(
+            sim.get_snake().get_head_position(), size, size
+        );
+
+        if(!simulation->step(direction)) {
+            t_state.PauseTiming();
+            simulation = std::make_unique<simulation_t<Field>>(
+                ++seed, make_field<Field>(size)
+            );
+            t_state.ResumeTiming();
+        }
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations());
+}
+
+// Ticks steered by autopilot_t, whose decision dominates: a search per
+// fruit and a cycle lookup per tick. One autopilot serves every restart.
+template<typename Field>
+void BM_AutopilotStep(benchmark::State& t_state)
+{
+    int const size = static_cast<int>(t_state.range(0));
+    std::uint64_t seed{ 1 };
+
+    auto simulation =
+        std::make_unique<simulation_t<Field>>(seed, make_field<Field>(size));
+    autopilot_t<Field> autopilot{ simulation->get_field() };
+
+    for(auto _ : t_state) {
+        if(!simulation->step(autopilot.next_direction(*simulation))) {
+            t_state.PauseTiming();
+            simulation = std::make_unique<simulation_t<Field>>(
+                ++seed, make_field<Field>(size)
+            );
+            autopilot.reset();
+            t_state.ResumeTiming();
+        }
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations());
+}
+
+// Copying a 10x10 game_state_t into a pool slot and handing it back, as a
+// tree search expanding a node would.
+void BM_StateClone(benchmark::State& t_state)
+{
+    game_state_t<10, 10> const state{ 1 };
+    state_pool_t<game_state_t<10, 10>> pool{ 16 };
+
+    for(auto _ : t_state) {
+        auto* clone = pool.clone(state);
+        benchmark::DoNotOptimize(clone);
+        pool.release(clone);
+    }
+
+    t_state.SetBytesProcessed(t_state.iterations() * sizeof(state));
+}
+
+// One step() and its undo(), the make/unmake pair of a tree search.
+template<typename Field>
+void BM_StepUndo(benchmark::State& t_state)
+{
+    int const size = static_cast<int>(t_state.range(0));
+    simulation_t<Field> simulation{ 1, make_field<Field>(size) };
+    tick_undo_t undo{};
+
+    for(auto _ : t_state) {
+        direction_type const direction = cycle_direction(
+            simulation.get_snake().get_head_position(), size, size
+        );
+
+        simulation.step(direction, undo);
+        simulation.undo(undo);
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations());
+}
+
+// Arguments: snakes on a 1024x1024 arena with half as many fruits, worker
+// threads (0 steps on the calling thread without the pool). Snakes keep
+// their heading and turn at random one tick in eight, dying and
+// respawning as they go. Items are snake ticks.
+void BM_ArenaStep(benchmark::State& t_state)
+{
+    auto const snakes = static_cast<std::size_t>(t_state.range(0));
+    auto const threads = static_cast<std::size_t>(t_state.range(1));
+
+    arena_options_t options{};
+    options.width = 1024;
+    options.height = 1024;
+    options.snakes = snakes;
+    options.fruits = snakes / 2;
+    options.seed = 1;
+
+    arena_simulation_t arena{ options };
+    std::vector<direction_type> directions(snakes);
+    std::unique_ptr<thread_pool_t> pool;
+    rng_engine_t policy{ 2 };
+
+    if(threads > 0) {
+        pool = std::make_unique<thread_pool_t>(threads);
+    }
+
+    for(auto _ : t_state) {
+        for(std::size_t snake = 0; snake < snakes; ++snake) {
+            std::uint32_t const draw = random_below(policy, 32);
+            directions[snake] = draw < 4
+                ? static_cast<direction_type>(draw)
+                : arena.get_direction(snake);
+        }
+
+        if(pool) {
+            arena.step(directions.data(), *pool);
+        }
+        else {
+            arena.step(directions.data());
+        }
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations() * snakes);
+}
+
+// Arguments: games in the batch, worker threads (0 steps on the calling
+// thread without the pool), batch_kernel_type. Items are game ticks.
+template<int Size>
+void BM_BatchStep(benchmark::State& t_state)
+{
+    auto const games = static_cast<std::size_t>(t_state.range(0));
+    auto const threads = static_cast<std::size_t>(t_state.range(1));
+    auto const kernel = static_cast<batch_kernel_type>(t_state.range(2));
+
+    if(!is_kernel_supported(kernel)) {
+        t_state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+
+    batch_simulation_t<Size, Size> batch{ games, 1 };
+    batch.set_kernel(kernel);
+    std::vector<direction_type> directions(games);
+    std::unique_ptr<thread_pool_t> pool;
+
+    if(threads > 0) {
+        pool = std::make_unique<thread_pool_t>(threads);
+    }
+
+    for(auto _ : t_state) {
+        for(std::size_t game = 0; game < games; ++game) {
+            directions[game] = cycle_direction(batch.get_head(game), Size, Size);
+        }
+
+        if(pool) {
+            batch.step(directions.data(), *pool);
+        }
+        else {
+            batch.step(directions.data());
+        }
+    }
+
+    t_state.SetItemsProcessed(t_state.iterations() * games);
+}
+
+namespace {
+    void board_sizes(benchmark::internal::Benchmark* t_benchmark)
+    {
+        for(int size : { 10, 64, 256, 1024, 4096 }) {
+            t_benchmark->Arg(size);
+        }
+    }
+
+    void board_sizes_and_fill(benchmark::internal::Benchmark* t_benchmark)
+    {
+        for(int size : { 10, 64, 256, 1024, 4096 }) {
+            for(int fill : { 1, 50, 90 }) {
+                t_benchmark->Args({ size, fill });
+            }
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_SnakeMove, default_game_field_t)->Args({ 10, 50 });
+BENCHMARK_TEMPLATE(BM_SnakeMove, dynamic_game_field_t)->Apply(board_sizes_and_fill);
+BENCHMARK_TEMPLATE(BM_SnakeMove, packed_game_field_t)->Apply(board_sizes_and_fill);
+
+BENCHMARK_TEMPLATE(BM_SnakeLengthen, default_game_field_t)->Arg(10);
+BENCHMARK_TEMPLATE(BM_SnakeLengthen, dynamic_game_field_t)->Apply(board_sizes);
+BENCHMARK_TEMPLATE(BM_SnakeLengthen, packed_game_field_t)->Apply(board_sizes);
+
+BENCHMARK_TEMPLATE(BM_FruitNewPosition, default_game_field_t)->Args({ 10, 50 });
+BENCHMARK_TEMPLATE(BM_FruitNewPosition, dynamic_game_field_t)->Apply(board_sizes_and_fill);
+
+BENCHMARK_TEMPLATE(BM_FieldDraw, default_game_field_t)->Args({ 10, 50 });
+BENCHMARK_TEMPLATE(BM_FieldDraw, dynamic_game_field_t)->Apply(board_sizes_and_fill);
+BENCHMARK_TEMPLATE(BM_FieldDraw, packed_game_field_t)->Apply(board_sizes_and_fill);
+
+BENCHMARK_TEMPLATE(BM_SimulationStep, default_game_field_t)->Arg(10);
+BENCHMARK_TEMPLATE(BM_SimulationStep, dynamic_game_field_t)->Apply(board_sizes);
+BENCHMARK_TEMPLATE(BM_SimulationStep, packed_game_field_t)->Apply(board_sizes);
+
+BENCHMARK_TEMPLATE(BM_AutopilotStep, default_game_field_t)->Arg(10);
+BENCHMARK_TEMPLATE(BM_AutopilotStep, dynamic_game_field_t)
+    ->Arg(10)->Arg(64)->Arg(256)->Arg(1024);
+
+BENCHMARK(BM_StateClone);
+BENCHMARK_TEMPLATE(BM_StepUndo, default_game_field_t)->Arg(10);
+BENCHMARK_TEMPLATE(BM_StepUndo, dynamic_game_field_t)->Apply(board_sizes);
+
+BENCHMARK_TEMPLATE(BM_BatchStep, 10)
+    ->ArgsProduct({ { 1024, 16384 }, { 0, 1, 2, 4, 8 }, { SCALAR_KERNEL, AVX2_KERNEL } })
+    ->UseRealTime();
+
+BENCHMARK(BM_ArenaStep)
+    ->ArgsProduct({ { 128, 1024, 8192 }, { 0, 1, 2, 4, 8 } })
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
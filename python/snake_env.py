@@ -0,0 +1,205 @@
+"""Vectorised snake environments on top of the snake_env C library.
+
+    env = SnakeEnv(num_envs=4096, width=10, height=10, seed=1)
+    obs = env.reset()
+    obs, rewards, dones = env.step(actions)
+
+Every step advances all games with one foreign call. ctypes drops the GIL
+for the length of the call, and the C side writes observations, rewards
+and dones straight into buffers allocated once here. Those buffers are
+returned as they are and are overwritten by the next step, so copy
+anything that has to outlive it. With numpy installed they are ndarrays
+(no copy is made); without it they are flat ctypes arrays.
+
+The library is looked up in $SNAKE_ENV_LIBRARY, next to this file and
+in ../build; pass `library=` to point elsewhere.
+"""
+
+import ctypes
+import os
+import sys
+
+try:
+    import numpy as np
+except ImportError:  # pragma: no cover - optional dependency
+    np = None
+
+OBS_NONE = -1
+OBS_CELLS = 0
+OBS_BITBOARD = 1
+
+UP, DOWN, LEFT, RIGHT = range(4)
+
+EMPTY, FRUIT, SNAKE_HEAD, SNAKE_BODY = range(4)
+
+
+def _library_names():
+    if sys.platform == "win32":
+        return ["snake_env.dll"]
+    if sys.platform == "darwin":
+        return ["libsnake_env.dylib"]
+    return ["libsnake_env.so"]
+
+
+def _find_library():
+    path = os.environ.get("SNAKE_ENV_LIBRARY")
+    if path:
+        return path
+
+    here = os.path.dirname(os.path.abspath(__file__))
+    for directory in (here, os.path.join(here, os.pardir, "build")):
+        for name in _library_names():
+            candidate = os.path.join(directory, name)
+            if os.path.exists(candidate):
+                return candidate
+
+    raise OSError("snake_env library not found; set SNAKE_ENV_LIBRARY")
+
+
+def _load(path):
+    # CDLL, unlike PyDLL, releases the GIL around each call.
+    lib = ctypes.CDLL(path)
+
+    lib.snake_env_create.restype = ctypes.c_void_p
+    lib.snake_env_create.argtypes = [
+        ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_uint64, ctypes.c_int
+    ]
+    lib.snake_env_destroy.restype = None
+    lib.snake_env_destroy.argtypes = [ctypes.c_void_p]
+
+    for name in ("snake_env_num_envs", "snake_env_width", "snake_env_height"):
+        function = getattr(lib, name)
+        function.restype = ctypes.c_int
+        function.argtypes = [ctypes.c_void_p]
+
+    lib.snake_env_observation_size.restype = ctypes.c_size_t
+    lib.snake_env_observation_size.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.snake_env_cells.restype = ctypes.POINTER(ctypes.c_uint8)
+    lib.snake_env_cells.argtypes = [ctypes.c_void_p]
+
+    lib.snake_env_reset.restype = ctypes.c_int
+    lib.snake_env_reset.argtypes = [
+        ctypes.c_void_p, ctypes.c_uint64, ctypes.c_int, ctypes.c_void_p
+    ]
+    lib.snake_env_step_batch.restype = ctypes.c_int
+    lib.snake_env_step_batch.argtypes = [
+        ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int, ctypes.c_void_p,
+        ctypes.c_void_p, ctypes.c_void_p
+    ]
+
+    return lib
+
+
+def _address(buffer):
+    if np is not None and isinstance(buffer, np.ndarray):
+        return buffer.ctypes.data
+    return ctypes.addressof(buffer)
+
+
+class SnakeEnv:
+    """num_envs games that reset themselves when they end.
+
+    observation is OBS_CELLS (uint8, shape (num_envs, height, width)),
+    OBS_BITBOARD (uint64, shape (num_envs, 3, words): head, body and fruit
+    planes, bit k of a plane being cell k) or OBS_NONE.
+    """
+
+    def __init__(self, num_envs, width=10, height=10, seed=0, threads=0,
+                 observation=OBS_CELLS, library=None):
+        # Set first so close() from __del__ is safe if loading fails.
+        self._env = None
+        self._lib = _load(library or _find_library())
+        self._env = self._lib.snake_env_create(num_envs, width, height, seed, threads)
+        if not self._env:
+            raise ValueError("invalid environment parameters")
+
+        self.num_envs = num_envs
+        self.width = width
+        self.height = height
+        self.observation = observation
+
+        self._observations = self._allocate_observations()
+        self._rewards = self._allocate(ctypes.c_float, "float32", (num_envs,))
+        self._dones = self._allocate(ctypes.c_uint8, "uint8", (num_envs,))
+        self._actions = None
+
+    def close(self):
+        if self._env:
+            self._lib.snake_env_destroy(self._env)
+            self._env = None
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _allocate(self, ctype, dtype, shape):
+        if np is not None:
+            return np.zeros(shape, dtype=dtype)
+        count = 1
+        for extent in shape:
+            count *= extent
+        return (ctype * count)()
+
+    def _allocate_observations(self):
+        if self.observation == OBS_NONE:
+            return None
+        size = self._lib.snake_env_observation_size(self._env, self.observation)
+        if size == 0:
+            raise ValueError("unknown observation format")
+        if self.observation == OBS_CELLS:
+            return self._allocate(ctypes.c_uint8, "uint8",
+                                  (self.num_envs, self.height, self.width))
+        words = size // (3 * 8)
+        return self._allocate(ctypes.c_uint64, "uint64", (self.num_envs, 3, words))
+
+    def _actions_address(self, actions):
+        if np is not None:
+            actions = np.ascontiguousarray(actions, dtype=np.int32)
+            if actions.shape != (self.num_envs,):
+                raise ValueError("expected %d actions" % self.num_envs)
+            self._actions = actions
+            return actions.ctypes.data
+        if len(actions) != self.num_envs:
+            raise ValueError("expected %d actions" % self.num_envs)
+        if self._actions is None:
+            self._actions = (ctypes.c_int32 * self.num_envs)()
+        self._actions[:] = actions
+        return ctypes.addressof(self._actions)
+
+    def reset(self, seed=0):
+        """Starts game k over from seed + k; returns the observations."""
+        observations = self._observations
+        status = self._lib.snake_env_reset(
+            self._env, seed, self.observation,
+            _address(observations) if observations is not None else None
+        )
+        if status != 0:
+            raise RuntimeError("snake_env_reset failed (%d)" % status)
+        return observations
+
+    def step(self, actions):
+        """Steps every game; returns (observations, rewards, dones)."""
+        observations = self._observations
+        status = self._lib.snake_env_step_batch(
+            self._env, self._actions_address(actions), self.observation,
+            _address(observations) if observations is not None else None,
+            _address(self._rewards), _address(self._dones)
+        )
+        if status != 0:
+            raise RuntimeError("snake_env_step_batch failed (%d)" % status)
+        return observations, self._rewards, self._dones
+
+    def cells(self):
+        """The engine's own cell planes, updated in place by every step."""
+        count = self.num_envs * self.height * self.width
+        pointer = self._lib.snake_env_cells(self._env)
+        if np is not None:
+            return np.ctypeslib.as_array(pointer, shape=(count,)).reshape(
+                self.num_envs, self.height, self.width)
+        return (ctypes.c_uint8 * count).from_address(
+            ctypes.addressof(pointer.contents))
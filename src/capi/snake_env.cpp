@@ -0,0 +1,206 @@
+#include "capi/snake_env.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "core/batch_simulation.hpp"
+#include "core/thread_pool.hpp"
+
+struct snake_env
+{
+    dynamic_batch_simulation_t batch;
+    std::unique_ptr<thread_pool_t> pool;
+    std::vector<direction_type> actions;
+
+    snake_env(std::size_t const t_count, int const t_width, int const t_height,
+              std::uint64_t const t_seed, std::size_t const t_threads)
+        : batch{ t_count, t_seed, dynamic_extent_t{ t_width, t_height } }
+        , actions(t_count, UP)
+    {
+        if(t_threads != 1) {
+            pool = std::make_unique<thread_pool_t>(t_threads);
+        }
+    }
+};
+
+namespace {
+    std::size_t bitboard_words(snake_env const& t_env) noexcept
+    { return (t_env.batch.cell_count() + 63) / 64; }
+
+    std::size_t observation_size(snake_env const& t_env, int const t_format) noexcept
+    {
+        switch(t_format) {
+            case SNAKE_OBS_CELLS:
+                return t_env.batch.cell_count();
+            case SNAKE_OBS_BITBOARD:
+                return 3 * bitboard_words(t_env) * sizeof(std::uint64_t);
+            default:
+                return 0;
+        }
+    }
+
+    bool valid_format(int const t_format) noexcept
+    {
+        return t_format == SNAKE_OBS_NONE || t_format == SNAKE_OBS_CELLS ||
+               t_format == SNAKE_OBS_BITBOARD;
+    }
+
+    void write_observation(snake_env const& t_env, std::size_t const t_game,
+                           int const t_format, void* t_observations) noexcept
+    {
+        std::size_t const cells = t_env.batch.cell_count();
+        auto const* source = t_env.batch.get_cells(t_game);
+        auto* const out = static_cast<std::uint8_t*>(t_observations)
+                        + t_game * observation_size(t_env, t_format);
+
+        if(t_format == SNAKE_OBS_CELLS) {
+            std::memcpy(out, source, cells);
+            return;
+        }
+
+        std::size_t const words = bitboard_words(t_env);
+        std::uint64_t* head = reinterpret_cast<std::uint64_t*>(out);
+        std::uint64_t* body = head + words;
+        std::uint64_t* fruit = body + words;
+
+        std::fill(head, head + 3 * words, std::uint64_t{ 0 });
+
+        for(std::size_t cell = 0; cell < cells; ++cell) {
+            std::uint64_t const bit = std::uint64_t{ 1 } << (cell % 64);
+
+            switch(source[cell]) {
+                case field_base_t::SNAKE_HEAD: head[cell / 64] |= bit; break;
+                case field_base_t::SNAKE_BODY: body[cell / 64] |= bit; break;
+                case field_base_t::FRUIT: fruit[cell / 64] |= bit; break;
+                default: break;
+            }
+        }
+    }
+
+    // Games per chunk: enough to amortise a steal, few enough to balance.
+    std::size_t grain(snake_env const& t_env) noexcept
+    {
+        std::size_t const workers = t_env.pool ? t_env.pool->size() : 1;
+        return std::max<std::size_t>(64, t_env.batch.size() / (workers * 8));
+    }
+
+    template<typename Function>
+    void for_each_range(snake_env& t_env, Function&& t_function)
+    {
+        if(t_env.pool) {
+            t_env.pool->parallel_for(0, t_env.batch.size(), grain(t_env), t_function);
+        }
+        else {
+            t_function(std::size_t{ 0 }, t_env.batch.size());
+        }
+    }
+}
+
+extern "C" {
+
+snake_env* snake_env_create(int const num_envs, int const width, int const height,
+                            std::uint64_t const seed, int const num_threads)
+{
+    if(num_envs <= 0 || width < 2 || height < 2 || width > 0xFFFF ||
+       height > 0xFFFF || num_threads < 0 ||
+       std::size_t(width) * height > max_kernel_cells(SCALAR_KERNEL)) {
+        return nullptr;
+    }
+
+    try {
+        return new snake_env{
+            static_cast<std::size_t>(num_envs), width, height, seed,
+            static_cast<std::size_t>(num_threads)
+        };
+    }
+    catch(std::exception const&) {
+        return nullptr;
+    }
+}
+
+void snake_env_destroy(snake_env* const env)
+{ delete env; }
+
+int snake_env_num_envs(snake_env const* const env)
+{ return env != nullptr ? static_cast<int>(env->batch.size()) : 0; }
+
+int snake_env_width(snake_env const* const env)
+{ return env != nullptr ? env->batch.width() : 0; }
+
+int snake_env_height(snake_env const* const env)
+{ return env != nullptr ? env->batch.height() : 0; }
+
+std::size_t snake_env_observation_size(snake_env const* const env, int const format)
+{ return env != nullptr ? observation_size(*env, format) : 0; }
+
+std::uint8_t const* snake_env_cells(snake_env const* const env)
+{
+    return env != nullptr
+        ? reinterpret_cast<std::uint8_t const*>(env->batch.get_cells(0))
+        : nullptr;
+}
+
+int snake_env_reset(snake_env* const env, std::uint64_t const seed,
+                    int const format, void* const observations)
+{
+    if(env == nullptr || !valid_format(format) ||
+       (format != SNAKE_OBS_NONE && observations == nullptr)) {
+        return SNAKE_ENV_INVALID_ARGUMENT;
+    }
+
+    env->batch.restart(seed);
+
+    if(format != SNAKE_OBS_NONE) {
+        for_each_range(*env, [env, format, observations](std::size_t const t_begin,
+                                                         std::size_t const t_end) {
+            for(std::size_t game = t_begin; game < t_end; ++game) {
+                write_observation(*env, game, format, observations);
+            }
+        });
+    }
+
+    return SNAKE_ENV_OK;
+}
+
+int snake_env_step_batch(snake_env* const env, std::int32_t const* const actions,
+                         int const format, void* const observations,
+                         float* const rewards, std::uint8_t* const dones)
+{
+    if(env == nullptr || actions == nullptr || !valid_format(format) ||
+       (format != SNAKE_OBS_NONE && observations == nullptr)) {
+        return SNAKE_ENV_INVALID_ARGUMENT;
+    }
+
+    // Each chunk steps its games and writes their outputs while the
+    // boards are still in cache.
+    for_each_range(*env, [=](std::size_t const t_begin, std::size_t const t_end) {
+        for(std::size_t game = t_begin; game < t_end; ++game) {
+            env->actions[game] = static_cast<direction_type>(actions[game] & 3);
+        }
+
+        env->batch.step(env->actions.data(), t_begin, t_end);
+
+        for(std::size_t game = t_begin; game < t_end; ++game) {
+            if(rewards != nullptr) {
+                switch(env->batch.get_result(game)) {
+                    case snake_base_t::ATE: rewards[game] = 1.0f; break;
+                    case snake_base_t::COLLIDED: rewards[game] = -1.0f; break;
+                    default: rewards[game] = 0.0f; break;
+                }
+            }
+            if(dones != nullptr) {
+                dones[game] = env->batch.get_done(game) ? 1 : 0;
+            }
+            if(format != SNAKE_OBS_NONE) {
+                write_observation(*env, game, format, observations);
+            }
+        }
+    });
+
+    return SNAKE_ENV_OK;
+}
+
+}
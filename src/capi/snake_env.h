@@ -0,0 +1,98 @@
+#ifndef SNAKE_ENV_H
+#define SNAKE_ENV_H
+
+/* C interface to a batch of headless snake games, for driving the core
+ * from other languages (see python/snake_env.py). One snake_env holds
+ * num_envs games on boards of one size; games that end are reset on the
+ * spot, so every call to snake_env_step_batch steps all of them.
+ *
+ * Observations are written straight into contiguous caller-owned buffers
+ * of num_envs * snake_env_observation_size() bytes, game after game:
+ *   SNAKE_OBS_CELLS     one byte per cell, row-major, holding the core's
+ *                       cell values (0 empty, 1 fruit, 2 head, 3 body)
+ *   SNAKE_OBS_BITBOARD  three planes per game (head, body, fruit) of
+ *                       ceil(cells / 64) uint64 words each, bit k of the
+ *                       plane being cell k; the buffer must be 8-byte
+ *                       aligned
+ * snake_env_cells() exposes the engine's own cell planes in the
+ * SNAKE_OBS_CELLS layout without any copy.
+ *
+ * Functions returning int return SNAKE_ENV_OK or a negative error. None
+ * of them calls back into the caller, so bindings may drop their
+ * interpreter lock around every call. A snake_env must not be used from
+ * two threads at once. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define SNAKE_ENV_API __declspec(dllexport)
+#else
+#define SNAKE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct snake_env snake_env;
+
+enum snake_env_status
+{
+    SNAKE_ENV_OK = 0,
+    SNAKE_ENV_INVALID_ARGUMENT = -1
+};
+
+enum snake_obs_format
+{
+    SNAKE_OBS_NONE = -1,
+    SNAKE_OBS_CELLS = 0,
+    SNAKE_OBS_BITBOARD = 1
+};
+
+/* Actions use the core's directions. */
+enum snake_action
+{
+    SNAKE_UP = 0,
+    SNAKE_DOWN = 1,
+    SNAKE_LEFT = 2,
+    SNAKE_RIGHT = 3
+};
+
+/* Game k of the batch starts from seed + k. num_threads counts the calling
+ * thread; 0 means one per hardware thread. Returns NULL on invalid
+ * arguments (boards smaller than 2x2, larger than 65535 per side or of
+ * more than 2^31 - 1 cells) or when out of memory. */
+SNAKE_ENV_API snake_env* snake_env_create(int num_envs, int width, int height,
+                                          uint64_t seed, int num_threads);
+SNAKE_ENV_API void snake_env_destroy(snake_env* env);
+
+SNAKE_ENV_API int snake_env_num_envs(snake_env const* env);
+SNAKE_ENV_API int snake_env_width(snake_env const* env);
+SNAKE_ENV_API int snake_env_height(snake_env const* env);
+/* Bytes per game for format; 0 for an unknown format. */
+SNAKE_ENV_API size_t snake_env_observation_size(snake_env const* env, int format);
+
+/* Read-only view of num_envs * width * height cells, valid until
+ * snake_env_destroy and updated in place by every step. */
+SNAKE_ENV_API uint8_t const* snake_env_cells(snake_env const* env);
+
+/* Starts every game over from seed + k and writes the first observations
+ * unless format is SNAKE_OBS_NONE. */
+SNAKE_ENV_API int snake_env_reset(snake_env* env, uint64_t seed,
+                                  int format, void* observations);
+
+/* Steps every game with actions[k] (a snake_action; other values are
+ * taken modulo 4). For each game, rewards gets +1 for a fruit, -1 for a
+ * collision and 0 otherwise, and dones gets 1 when the episode ended
+ * (collision or full board), in which case the observation already shows
+ * the fresh board. rewards, dones and observations may each be NULL. */
+SNAKE_ENV_API int snake_env_step_batch(snake_env* env, int32_t const* actions,
+                                       int format, void* observations,
+                                       float* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
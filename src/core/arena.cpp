@@ -0,0 +1,269 @@
+#include "core/arena.hpp"
+
+#include <algorithm>
+
+#include "core/trace.hpp"
+
+namespace {
+    std::size_t constexpr initial_body_capacity{ 4 };
+    // Snakes per plan chunk; tiles per resolve chunk.
+    std::size_t constexpr snake_grain{ 256 };
+    std::size_t constexpr tile_grain{ 4 };
+}
+
+arena_simulation_t::arena_simulation_t(arena_options_t const& t_options)
+    : m_options{ t_options }
+    , m_field{ dynamic_extent_t{ t_options.width, t_options.height } }
+    , m_rng{ t_options.seed }
+    , m_direction(t_options.snakes, UP)
+    , m_alive(t_options.snakes, 0)
+    , m_result(t_options.snakes, snake_base_t::MOVED)
+    , m_target(t_options.snakes, -1)
+    , m_binned(t_options.snakes)
+    , m_claim(std::size_t(t_options.width) * t_options.height, 0)
+    , m_claimer(std::size_t(t_options.width) * t_options.height)
+{
+    m_options.tile_size = std::max(1, m_options.tile_size);
+    m_tiles_x = (m_field.width() + m_options.tile_size - 1) / m_options.tile_size;
+    m_tiles_y = (m_field.height() + m_options.tile_size - 1) / m_options.tile_size;
+    m_bin_start.resize(this->tile_count() + 1);
+    m_deaths.reserve(m_options.snakes);
+    m_new_fruits.reserve(m_options.snakes + m_options.fruits);
+    m_spawns.reserve(m_options.snakes);
+
+    m_bodies.reserve(m_options.snakes);
+    for(std::size_t snake = 0; snake < m_options.snakes; ++snake) {
+        m_bodies.emplace_back(std::vector<position_t>(initial_body_capacity));
+        this->spawn(snake);
+    }
+    for(std::size_t fruit = 0; fruit < m_options.fruits; ++fruit) {
+        this->place_fruit();
+    }
+    m_new_fruits.clear();
+}
+
+bool arena_simulation_t::spawn(std::size_t const t_snake)
+{
+    auto const free_cells = static_cast<std::uint32_t>(m_field.free_cell_count());
+    if(free_cells == 0) {
+        return false;
+    }
+
+    position_t const head = m_field.free_cell(random_below(m_rng, free_cells));
+    m_field.set(head.i, head.j, field_type::SNAKE_HEAD);
+
+    m_bodies[t_snake].clear();
+    m_bodies[t_snake].push_front(head);
+    m_direction[t_snake] = static_cast<direction_type>(random_below(m_rng, 4));
+    m_alive[t_snake] = 1;
+    ++m_alive_count;
+    return true;
+}
+
+void arena_simulation_t::place_fruit()
+{
+    auto const free_cells = static_cast<std::uint32_t>(m_field.free_cell_count());
+    if(free_cells == 0) {
+        return;
+    }
+
+    position_t const fruit = m_field.free_cell(random_below(m_rng, free_cells));
+    m_field.set(fruit.i, fruit.j, field_type::FRUIT);
+    m_new_fruits.push_back(fruit);
+}
+
+void arena_simulation_t::remove(std::size_t const t_snake)
+{
+    body_t& body = m_bodies[t_snake];
+
+    for(std::size_t k = 0; k < body.size(); ++k) {
+        m_field.set(body[k].i, body[k].j, field_type::EMPTY);
+    }
+
+    body.clear();
+    m_alive[t_snake] = 0;
+    --m_alive_count;
+}
+
+void arena_simulation_t::plan(direction_type const* t_directions,
+                              std::size_t const t_begin,
+                              std::size_t const t_end) noexcept
+{
+    SNAKE_TRACE_ZONE("arena_simulation_t::plan");
+
+    for(std::size_t snake = t_begin; snake < t_end; ++snake) {
+        m_target[snake] = -1;
+        if(m_alive[snake] == 0) {
+            continue;
+        }
+
+        // As in simulation_t, a reversal onto the snake's own neck is
+        // ignored.
+        direction_type const requested = t_directions[snake];
+        if(requested != opposite(m_direction[snake])) {
+            m_direction[snake] = requested;
+        }
+
+        position_t const next = neighbour(m_bodies[snake].front(), m_direction[snake]);
+        if(!is_inside(next, m_field.width(), m_field.height())) {
+            m_result[snake] = snake_base_t::COLLIDED;
+            continue;
+        }
+
+        m_target[snake] = next.i * m_field.width() + next.j;
+        m_result[snake] = snake_base_t::MOVED;
+    }
+}
+
+void arena_simulation_t::bin()
+{
+    SNAKE_TRACE_ZONE("arena_simulation_t::bin");
+
+    std::fill(m_bin_start.begin(), m_bin_start.end(), std::size_t{ 0 });
+
+    for(std::size_t snake = 0; snake < this->size(); ++snake) {
+        if(m_target[snake] >= 0) {
+            ++m_bin_start[this->tile_of(m_target[snake]) + 1];
+        }
+    }
+    for(std::size_t tile = 1; tile < m_bin_start.size(); ++tile) {
+        m_bin_start[tile] += m_bin_start[tile - 1];
+    }
+
+    // Filling moves every start to the next tile's; shifted back after.
+    for(std::size_t snake = 0; snake < this->size(); ++snake) {
+        if(m_target[snake] >= 0) {
+            m_binned[m_bin_start[this->tile_of(m_target[snake])]++] = snake;
+        }
+    }
+    for(std::size_t tile = m_bin_start.size() - 1; tile > 0; --tile) {
+        m_bin_start[tile] = m_bin_start[tile - 1];
+    }
+    m_bin_start[0] = 0;
+}
+
+void arena_simulation_t::resolve(std::size_t const t_begin,
+                                 std::size_t const t_end) noexcept
+{
+    SNAKE_TRACE_ZONE("arena_simulation_t::resolve");
+
+    for(std::size_t k = m_bin_start[t_begin]; k < m_bin_start[t_end]; ++k) {
+        std::size_t const snake = m_binned[k];
+        auto const cell = static_cast<std::size_t>(m_target[snake]);
+
+        if(m_claim[cell] == m_tick) {
+            m_result[snake] = snake_base_t::COLLIDED;
+            m_result[m_claimer[cell]] = snake_base_t::COLLIDED;
+            continue;
+        }
+        m_claim[cell] = m_tick;
+        m_claimer[cell] = snake;
+
+        int const i = static_cast<int>(cell) / m_field.width();
+        int const j = static_cast<int>(cell) % m_field.width();
+
+        if(m_field.is_snake(i, j)) {
+            m_result[snake] = snake_base_t::COLLIDED;
+        }
+        else if(m_field(i, j) == field_type::FRUIT) {
+            m_result[snake] = snake_base_t::ATE;
+        }
+    }
+}
+
+void arena_simulation_t::apply()
+{
+    SNAKE_TRACE_ZONE("arena_simulation_t::apply");
+
+    std::size_t eaten{ 0 };
+
+    for(std::size_t snake = 0; snake < this->size(); ++snake) {
+        if(m_alive[snake] == 0) {
+            continue;
+        }
+
+        auto const result = static_cast<move_result>(m_result[snake]);
+        if(result == snake_base_t::COLLIDED) {
+            this->remove(snake);
+            m_deaths.push_back(snake);
+            continue;
+        }
+
+        body_t& body = m_bodies[snake];
+        if(body.full()) {
+            body.reallocate(std::vector<position_t>(body.capacity() * 2));
+        }
+
+        // Head first, then the tail, in the order snake_t updates cells.
+        position_t const old_head = body.front();
+        position_t const head{ m_target[snake] / m_field.width(),
+                               m_target[snake] % m_field.width() };
+
+        body.push_front(head);
+        m_field.set(old_head.i, old_head.j, field_type::SNAKE_BODY);
+        m_field.set(head.i, head.j, field_type::SNAKE_HEAD);
+
+        if(result == snake_base_t::ATE) {
+            ++eaten;
+            continue;
+        }
+
+        position_t const tail = body.back();
+        m_field.set(tail.i, tail.j, field_type::EMPTY);
+        body.pop_back();
+    }
+
+    for(std::size_t fruit = 0; fruit < eaten; ++fruit) {
+        this->place_fruit();
+    }
+
+    if(m_options.respawn) {
+        for(std::size_t snake = 0; snake < this->size(); ++snake) {
+            if(m_alive[snake] == 0) {
+                if(!this->spawn(snake)) {
+                    break;
+                }
+                m_spawns.push_back(snake);
+            }
+        }
+    }
+}
+
+void arena_simulation_t::begin_tick() noexcept
+{
+    m_deaths.clear();
+    m_new_fruits.clear();
+    m_spawns.clear();
+
+    if(++m_tick == 0) {
+        std::fill(m_claim.begin(), m_claim.end(), std::uint32_t{ 0 });
+        m_tick = 1;
+    }
+}
+
+void arena_simulation_t::step(direction_type const* t_directions)
+{
+    this->begin_tick();
+    this->plan(t_directions, 0, this->size());
+    this->bin();
+    this->resolve(0, this->tile_count());
+    this->apply();
+}
+
+void arena_simulation_t::step(direction_type const* t_directions,
+                              thread_pool_t& t_pool)
+{
+    this->begin_tick();
+    t_pool.parallel_for(0, this->size(), snake_grain,
+        [this, t_directions](std::size_t const t_begin, std::size_t const t_end) {
+            this->plan(t_directions, t_begin, t_end);
+        }
+    );
+    this->bin();
+    t_pool.parallel_for(0, this->tile_count(), tile_grain,
+        [this](std::size_t const t_begin, std::size_t const t_end) {
+            this->resolve(t_begin, t_end);
+        }
+    );
+    this->apply();
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+#include "core/random.hpp"
+#include "core/ring_buffer.hpp"
+#include "core/thread_pool.hpp"
+#include "core/tick_delta.hpp"
+
+struct arena_options_t
+{
+    int width{ 256 };
+    int height{ 256 };
+    std::size_t snakes{ 128 };
+    // Kept on the board: every fruit eaten is replaced in the same tick.
+    std::size_t fruits{ 64 };
+    // Side of the square tiles collisions are resolved in.
+    int tile_size{ 32 };
+    // Put a snake that died back on the board, one cell long, at the end
+    // of the tick; otherwise it stays out.
+    bool respawn{ true };
+    std::uint64_t seed{ 0 };
+};
+
+// Many snakes and fruits on one shared board. Every tick runs in phases:
+//   plan     each live snake turns and picks its target cell (parallel
+//            over snakes; reads only its own state)
+//   bin      snakes are counting-sorted by the tile their target lies in,
+//            keeping snake order within a tile
+//   resolve  each tile settles the snakes aiming into it (parallel over
+//            tiles; every contender for a cell lands in the cell's tile)
+//   apply    the board, free-cell index and bodies are updated, dead
+//            snakes removed, fruits and snakes placed (serial, in snake
+//            order)
+// Collisions are judged against the board as it was at the start of the
+// tick: moving into any snake cell, a tail about to move away included
+// (as for a single snake), or off the board kills the mover, and every
+// snake moving into the same cell dies. So the outcome depends only on
+// the seed and the directions, never on the thread count or the order in
+// which tiles finish.
+struct arena_simulation_t
+{
+public:
+    using field_type = dynamic_game_field_t;
+    using move_result = snake_base_t::move_result;
+
+private:
+    using body_t = ring_buffer_t<std::vector<position_t>>;
+
+    arena_options_t m_options;
+    field_type m_field;
+    rng_engine_t m_rng;
+
+    std::vector<body_t> m_bodies;
+    std::vector<direction_type> m_direction;
+    std::vector<std::uint8_t> m_alive;
+    std::vector<std::uint8_t> m_result;
+    // Cell the snake moves into this tick, -1 if it went off the board.
+    std::vector<int> m_target;
+
+    int m_tiles_x{ 0 };
+    int m_tiles_y{ 0 };
+    // Snakes of tile t are m_binned[m_bin_start[t], m_bin_start[t + 1]).
+    std::vector<std::size_t> m_bin_start;
+    std::vector<std::size_t> m_binned;
+
+    // m_claimer[cell] is the first snake of this tick aiming at cell iff
+    // m_claim[cell] is m_tick, so no plane is cleared between ticks.
+    std::vector<std::uint32_t> m_claim;
+    std::vector<std::size_t> m_claimer;
+    std::uint32_t m_tick{ 0 };
+
+    std::size_t m_alive_count{ 0 };
+
+    // What the last tick did besides moving snakes, in the order it
+    // happened; see get_deaths().
+    std::vector<std::size_t> m_deaths;
+    std::vector<position_t> m_new_fruits;
+    std::vector<std::size_t> m_spawns;
+
+    inline int tile_of(int const t_cell) const noexcept
+    {
+        int const i = t_cell / m_field.width();
+        int const j = t_cell % m_field.width();
+        return (i / m_options.tile_size) * m_tiles_x + j / m_options.tile_size;
+    }
+
+    // Puts snake t_snake on a random free cell; false if there is none.
+    bool spawn(std::size_t const t_snake);
+    // Puts a fruit on a random free cell if there is one.
+    void place_fruit();
+    void remove(std::size_t const t_snake);
+
+    void begin_tick() noexcept;
+    void plan(direction_type const* t_directions, std::size_t const t_begin,
+              std::size_t const t_end) noexcept;
+    void bin();
+    void resolve(std::size_t const t_begin, std::size_t const t_end) noexcept;
+    void apply();
+
+public:
+    explicit arena_simulation_t(arena_options_t const& t_options);
+    arena_simulation_t(arena_simulation_t const&) = delete;
+    arena_simulation_t& operator=(arena_simulation_t const&) = delete;
+    ~arena_simulation_t() noexcept = default;
+
+    // Advances every live snake by a tick; t_directions is indexed by
+    // snake, and dead snakes' entries are ignored.
+    void step(direction_type const* t_directions);
+    // Same, with plan and resolve spread over t_pool.
+    void step(direction_type const* t_directions, thread_pool_t& t_pool);
+
+    inline std::size_t size() const noexcept
+    { return m_bodies.size(); }
+    inline std::size_t alive_count() const noexcept
+    { return m_alive_count; }
+    inline field_type const& get_field() const noexcept
+    { return m_field; }
+    inline std::size_t tile_count() const noexcept
+    { return std::size_t(m_tiles_x) * m_tiles_y; }
+
+    inline bool is_alive(std::size_t const t_snake) const noexcept
+    { return m_alive[t_snake] != 0; }
+    // What t_snake's last tick did; COLLIDED means it died, even if it
+    // has since been respawned.
+    inline move_result get_result(std::size_t const t_snake) const noexcept
+    { return static_cast<move_result>(m_result[t_snake]); }
+    inline std::size_t get_length(std::size_t const t_snake) const noexcept
+    { return m_bodies[t_snake].size(); }
+    // t_snake must be alive.
+    inline position_t get_head(std::size_t const t_snake) const noexcept
+    { return m_bodies[t_snake].front(); }
+    inline direction_type get_direction(std::size_t const t_snake) const noexcept
+    { return m_direction[t_snake]; }
+    // t_index counts from the head, which is get_position(t_snake, 0).
+    inline position_t get_position(std::size_t const t_snake,
+                                   std::size_t const t_index) const noexcept
+    { return m_bodies[t_snake][t_index]; }
+
+    // The last tick, as the cells it changed: first the snakes in
+    // get_deaths() were taken off the board, then every live snake whose
+    // result is not COLLIDED moved its head one cell in get_direction()
+    // (dropping its tail unless it ATE), then the fruits in
+    // get_new_fruits() were placed and last the snakes in get_spawns()
+    // put back as a single head. Everything is in snake order.
+    inline std::vector<std::size_t> const& get_deaths() const noexcept
+    { return m_deaths; }
+    inline std::vector<position_t> const& get_new_fruits() const noexcept
+    { return m_new_fruits; }
+    inline std::vector<std::size_t> const& get_spawns() const noexcept
+    { return m_spawns; }
+};
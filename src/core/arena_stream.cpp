@@ -0,0 +1,455 @@
+#include "core/arena_stream.hpp"
+
+#include <algorithm>
+
+#include "core/varint.hpp"
+
+namespace {
+    // Boards a malformed snapshot can't make the view allocate past.
+    std::uint64_t constexpr max_cells{ std::uint64_t{ 1 } << 28 };
+
+    std::size_t begin_frame(std::vector<std::uint8_t>& t_out, arena_frame_kind const t_kind)
+    {
+        std::size_t const start = t_out.size();
+
+        t_out.resize(start + arena_frame_header_size);
+        t_out.push_back(t_kind);
+        return start;
+    }
+
+    void end_frame(std::vector<std::uint8_t>& t_out, std::size_t const t_start)
+    {
+        auto const size = static_cast<std::uint32_t>(
+            t_out.size() - t_start - arena_frame_header_size
+        );
+
+        for(std::size_t k = 0; k < arena_frame_header_size; ++k) {
+            t_out[t_start + k] = static_cast<std::uint8_t>(size >> (8 * k));
+        }
+    }
+
+    // Ids skipped since the previous one of the list; t_next starts at 0.
+    std::uint64_t id_gap(std::size_t& t_next, std::size_t const t_id) noexcept
+    {
+        std::uint64_t const gap = t_id - t_next;
+        t_next = t_id + 1;
+        return gap;
+    }
+
+    // The id id_gap() gave t_gap for; false if it is t_count or past.
+    bool from_gap(std::size_t& t_next, std::uint64_t const t_gap,
+                  std::size_t const t_count, std::size_t& t_id) noexcept
+    {
+        if(t_next >= t_count || t_gap >= t_count - t_next) {
+            return false;
+        }
+
+        t_id = t_next + static_cast<std::size_t>(t_gap);
+        t_next = t_id + 1;
+        return true;
+    }
+
+    bool is_moving(arena_simulation_t const& t_arena, std::size_t const t_snake) noexcept
+    {
+        return t_arena.is_alive(t_snake) &&
+               t_arena.get_result(t_snake) != snake_base_t::COLLIDED;
+    }
+
+    std::uint64_t cell_of(arena_simulation_t const& t_arena, position_t const& t_pos) noexcept
+    { return std::uint64_t(t_pos.i) * t_arena.get_field().width() + t_pos.j; }
+}
+
+void encode_arena_snapshot(arena_simulation_t const& t_arena, std::uint64_t const t_tick,
+                           std::vector<std::uint8_t>& t_out)
+{
+    auto const& field = t_arena.get_field();
+    std::size_t const start = begin_frame(t_out, ARENA_SNAPSHOT);
+
+    put_varint(t_out, t_tick);
+    put_varint(t_out, static_cast<std::uint64_t>(field.width()));
+    put_varint(t_out, static_cast<std::uint64_t>(field.height()));
+    put_varint(t_out, t_arena.size());
+
+    for(std::size_t snake = 0; snake < t_arena.size(); ++snake) {
+        if(!t_arena.is_alive(snake)) {
+            put_varint(t_out, 0);
+            continue;
+        }
+
+        std::size_t const length = t_arena.get_length(snake);
+        put_varint(t_out, length);
+        put_varint(t_out, cell_of(t_arena, t_arena.get_position(snake, 0)));
+        put_varint(t_out, t_arena.get_direction(snake));
+
+        std::uint8_t packed{ 0 };
+        for(std::size_t k = 1; k < length; ++k) {
+            direction_type const step = direction_between(
+                t_arena.get_position(snake, k - 1), t_arena.get_position(snake, k)
+            );
+            packed |= static_cast<std::uint8_t>(step << (2 * ((k - 1) % 4)));
+
+            if((k - 1) % 4 == 3 || k + 1 == length) {
+                t_out.push_back(packed);
+                packed = 0;
+            }
+        }
+    }
+
+    std::uint64_t fruits{ 0 };
+    for(int i = 0; i < field.height(); ++i) {
+        for(int j = 0; j < field.width(); ++j) {
+            fruits += field(i, j) == field_base_t::FRUIT;
+        }
+    }
+
+    put_varint(t_out, fruits);
+    std::uint64_t previous{ 0 };
+    for(int i = 0; i < field.height(); ++i) {
+        for(int j = 0; j < field.width(); ++j) {
+            if(field(i, j) == field_base_t::FRUIT) {
+                std::uint64_t const cell = cell_of(t_arena, { i, j });
+                put_varint(t_out, cell - previous);
+                previous = cell;
+            }
+        }
+    }
+
+    end_frame(t_out, start);
+}
+
+void encode_arena_tick(arena_simulation_t const& t_arena, std::uint64_t const t_tick,
+                       bool const t_checksum, std::vector<std::uint8_t>& t_out)
+{
+    std::size_t const start = begin_frame(t_out, ARENA_TICK);
+
+    put_varint(t_out, t_tick);
+    put_varint(t_out, t_checksum ? ARENA_CHECKSUM : 0);
+
+    std::size_t next{ 0 };
+    put_varint(t_out, t_arena.get_deaths().size());
+    for(std::size_t const snake : t_arena.get_deaths()) {
+        put_varint(t_out, id_gap(next, snake));
+    }
+
+    std::uint64_t moves{ 0 };
+    for(std::size_t snake = 0; snake < t_arena.size(); ++snake) {
+        moves += is_moving(t_arena, snake);
+    }
+
+    next = 0;
+    put_varint(t_out, moves);
+    for(std::size_t snake = 0; snake < t_arena.size(); ++snake) {
+        if(is_moving(t_arena, snake)) {
+            bool const ate = t_arena.get_result(snake) == snake_base_t::ATE;
+            put_varint(t_out, id_gap(next, snake) << 3 |
+                              std::uint64_t{ t_arena.get_direction(snake) } << 1 | ate);
+        }
+    }
+
+    put_varint(t_out, t_arena.get_new_fruits().size());
+    for(position_t const& fruit : t_arena.get_new_fruits()) {
+        put_varint(t_out, cell_of(t_arena, fruit));
+    }
+
+    next = 0;
+    put_varint(t_out, t_arena.get_spawns().size());
+    for(std::size_t const snake : t_arena.get_spawns()) {
+        put_varint(t_out, id_gap(next, snake));
+        put_varint(t_out, cell_of(t_arena, t_arena.get_position(snake, 0)) << 2 |
+                          t_arena.get_direction(snake));
+    }
+
+    if(t_checksum) {
+        auto const& field = t_arena.get_field();
+        arena_checksum_t checksum{};
+
+        for(int i = 0; i < field.height(); ++i) {
+            for(int j = 0; j < field.width(); ++j) {
+                checksum.add(field(i, j));
+            }
+        }
+        put_varint(t_out, checksum.value);
+    }
+
+    end_frame(t_out, start);
+}
+
+bool peek_arena_frame(std::uint8_t const* t_data, std::size_t const t_size,
+                      std::size_t& t_payload_size) noexcept
+{
+    if(t_size < arena_frame_header_size) {
+        return false;
+    }
+
+    std::uint32_t size{ 0 };
+    for(std::size_t k = 0; k < arena_frame_header_size; ++k) {
+        size |= std::uint32_t{ t_data[k] } << (8 * k);
+    }
+
+    t_payload_size = size;
+    return true;
+}
+
+void arena_view_t::push_head(std::size_t const t_snake, position_t const& t_head)
+{
+    body_t& body = m_bodies[t_snake];
+
+    if(body.full()) {
+        body.reallocate(std::vector<position_t>(std::max<std::size_t>(4, body.capacity() * 2)));
+    }
+    body.push_front(t_head);
+}
+
+bool arena_view_t::apply(std::uint8_t const* t_payload, std::size_t const t_size)
+{
+    bool ok{ false };
+
+    if(t_size > 0 && t_payload[0] == ARENA_SNAPSHOT) {
+        ok = this->apply_snapshot(t_payload + 1, t_payload + t_size);
+    }
+    else if(t_size > 0 && t_payload[0] == ARENA_TICK && m_synced) {
+        ok = this->apply_tick(t_payload + 1, t_payload + t_size);
+    }
+
+    m_synced = ok;
+    return ok;
+}
+
+bool arena_view_t::apply_snapshot(std::uint8_t const* t_data, std::uint8_t const* t_end)
+{
+    std::uint64_t tick{ 0 };
+    std::uint64_t slots{ 0 };
+    int width{ 0 };
+    int height{ 0 };
+
+    if(!get_varint(t_data, t_end, tick) || !get_varint(t_data, t_end, width) ||
+       !get_varint(t_data, t_end, height) || !get_varint(t_data, t_end, slots) ||
+       width < 1 || height < 1 || std::uint64_t(width) * height > max_cells ||
+       slots > std::uint64_t(width) * height) {
+        return false;
+    }
+
+    std::size_t const cells = std::size_t(width) * height;
+    m_width = width;
+    m_height = height;
+    m_tick = tick;
+    m_cells.assign(cells, field_base_t::EMPTY);
+    m_bodies.assign(slots, body_t{ std::vector<position_t>(4) });
+    m_direction.assign(slots, UP);
+    m_moved.assign(slots, 0);
+    m_old_tail.assign(slots, position_t{});
+
+    for(std::size_t snake = 0; snake < slots; ++snake) {
+        std::uint64_t length{ 0 };
+        std::uint64_t head{ 0 };
+        std::uint64_t direction{ 0 };
+
+        if(!get_varint(t_data, t_end, length) || length > cells) {
+            return false;
+        }
+        if(length == 0) {
+            continue;
+        }
+        if(!get_varint(t_data, t_end, head) || head >= cells ||
+           !get_varint(t_data, t_end, direction) || direction > RIGHT) {
+            return false;
+        }
+
+        body_t& body = m_bodies[snake];
+        body.reallocate(std::vector<position_t>(std::max<std::size_t>(4, length)));
+
+        position_t pos{ static_cast<int>(head / width), static_cast<int>(head % width) };
+        body.push_back(pos);
+        this->cell(pos) = field_base_t::SNAKE_HEAD;
+
+        std::uint8_t packed{ 0 };
+        for(std::size_t k = 1; k < length; ++k) {
+            if((k - 1) % 4 == 0) {
+                if(t_data == t_end) {
+                    return false;
+                }
+                packed = *t_data++;
+            }
+
+            auto const step = static_cast<direction_type>((packed >> (2 * ((k - 1) % 4))) & 3);
+            pos = neighbour(pos, step);
+            if(!this->on_board(pos) || this->cell(pos) != field_base_t::EMPTY) {
+                return false;
+            }
+
+            body.push_back(pos);
+            this->cell(pos) = field_base_t::SNAKE_BODY;
+        }
+
+        m_direction[snake] = static_cast<direction_type>(direction);
+        m_old_tail[snake] = body.back();
+    }
+
+    std::uint64_t fruits{ 0 };
+    std::uint64_t cell{ 0 };
+    if(!get_varint(t_data, t_end, fruits) || fruits > cells) {
+        return false;
+    }
+    for(std::uint64_t fruit = 0; fruit < fruits; ++fruit) {
+        std::uint64_t gap{ 0 };
+        if(!get_varint(t_data, t_end, gap) || gap >= cells - cell ||
+           m_cells[cell + gap] != field_base_t::EMPTY) {
+            return false;
+        }
+
+        cell += gap;
+        m_cells[cell] = field_base_t::FRUIT;
+    }
+
+    return t_data == t_end;
+}
+
+bool arena_view_t::apply_tick(std::uint8_t const* t_data, std::uint8_t const* t_end)
+{
+    std::size_t const cells = m_cells.size();
+    std::uint64_t tick{ 0 };
+    std::uint64_t flags{ 0 };
+    std::uint64_t count{ 0 };
+    std::uint64_t value{ 0 };
+    std::size_t next{ 0 };
+    std::size_t snake{ 0 };
+
+    if(!get_varint(t_data, t_end, tick) || tick != m_tick + 1 ||
+       !get_varint(t_data, t_end, flags)) {
+        return false;
+    }
+
+    std::fill(m_moved.begin(), m_moved.end(), std::uint8_t{ 0 });
+
+    if(!get_varint(t_data, t_end, count)) {
+        return false;
+    }
+    for(std::uint64_t k = 0; k < count; ++k) {
+        if(!get_varint(t_data, t_end, value) ||
+           !from_gap(next, value, this->size(), snake) ||
+           !this->is_alive(snake)) {
+            return false;
+        }
+
+        body_t& body = m_bodies[snake];
+        for(std::size_t segment = 0; segment < body.size(); ++segment) {
+            this->cell(body[segment]) = field_base_t::EMPTY;
+        }
+        body.clear();
+    }
+
+    next = 0;
+    if(!get_varint(t_data, t_end, count)) {
+        return false;
+    }
+    for(std::uint64_t k = 0; k < count; ++k) {
+        if(!get_varint(t_data, t_end, value) ||
+           !from_gap(next, value >> 3, this->size(), snake) ||
+           !this->is_alive(snake)) {
+            return false;
+        }
+
+        auto const direction = static_cast<direction_type>((value >> 1) & 3);
+        bool const ate = (value & 1) != 0;
+        body_t& body = m_bodies[snake];
+        position_t const old_head = body.front();
+        position_t const head = neighbour(old_head, direction);
+
+        if(!this->on_board(head) ||
+           this->cell(head) != (ate ? field_base_t::FRUIT : field_base_t::EMPTY)) {
+            return false;
+        }
+
+        this->push_head(snake, head);
+        this->cell(old_head) = field_base_t::SNAKE_BODY;
+        this->cell(head) = field_base_t::SNAKE_HEAD;
+        m_old_tail[snake] = body.back();
+
+        if(!ate) {
+            this->cell(body.back()) = field_base_t::EMPTY;
+            body.pop_back();
+        }
+
+        m_direction[snake] = direction;
+        m_moved[snake] = 1;
+    }
+
+    if(!get_varint(t_data, t_end, count)) {
+        return false;
+    }
+    for(std::uint64_t k = 0; k < count; ++k) {
+        if(!get_varint(t_data, t_end, value) || value >= cells ||
+           m_cells[value] != field_base_t::EMPTY) {
+            return false;
+        }
+        m_cells[value] = field_base_t::FRUIT;
+    }
+
+    next = 0;
+    if(!get_varint(t_data, t_end, count)) {
+        return false;
+    }
+    for(std::uint64_t k = 0; k < count; ++k) {
+        if(!get_varint(t_data, t_end, value) ||
+           !from_gap(next, value, this->size(), snake) ||
+           this->is_alive(snake) || !get_varint(t_data, t_end, value) ||
+           (value >> 2) >= cells || m_cells[value >> 2] != field_base_t::EMPTY) {
+            return false;
+        }
+
+        position_t const head{ static_cast<int>((value >> 2) / m_width),
+                               static_cast<int>((value >> 2) % m_width) };
+        this->push_head(snake, head);
+        this->cell(head) = field_base_t::SNAKE_HEAD;
+        m_direction[snake] = static_cast<direction_type>(value & 3);
+        m_old_tail[snake] = head;
+    }
+
+    if((flags & ARENA_CHECKSUM) != 0 &&
+       (!get_varint(t_data, t_end, value) || value != this->checksum())) {
+        return false;
+    }
+
+    m_tick = tick;
+    return t_data == t_end;
+}
+
+std::uint64_t arena_view_t::checksum() const noexcept
+{
+    arena_checksum_t checksum{};
+
+    for(cell_type const cell : m_cells) {
+        checksum.add(cell);
+    }
+    return checksum.value;
+}
+
+arena_view_t::point_t arena_view_t::head_at(std::size_t const t_snake,
+                                            double const t_alpha) const noexcept
+{
+    body_t const& body = m_bodies[t_snake];
+    position_t const head = body.front();
+
+    if(m_moved[t_snake] == 0) {
+        return { double(head.i), double(head.j) };
+    }
+
+    position_t const from = body.size() > 1 ? body[1] : m_old_tail[t_snake];
+    return {
+        from.i + (head.i - from.i) * t_alpha,
+        from.j + (head.j - from.j) * t_alpha
+    };
+}
+
+arena_view_t::point_t arena_view_t::tail_at(std::size_t const t_snake,
+                                            double const t_alpha) const noexcept
+{
+    body_t const& body = m_bodies[t_snake];
+    position_t const tail = body.back();
+    position_t const from = m_old_tail[t_snake];
+
+    return {
+        from.i + (tail.i - from.i) * t_alpha,
+        from.j + (tail.j - from.j) * t_alpha
+    };
+}
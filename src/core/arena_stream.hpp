@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/arena.hpp"
+#include "core/cell_storage.hpp"
+#include "core/position.hpp"
+#include "core/ring_buffer.hpp"
+
+// Wire format for streaming an arena to spectators: one snapshot when a
+// spectator joins, then one tick frame per tick holding only what the
+// tick changed, i.e. arena_simulation_t's get_deaths(), moves,
+// get_new_fruits() and get_spawns(). A moving snake costs one byte or so;
+// its tail is implied, since the spectator keeps every body.
+//
+// Each frame is a payload length (4 bytes, little-endian) followed by the
+// payload, whose first byte is its arena_frame_kind. After that every
+// number is an unsigned varint (see varint.hpp). Snake ids in a list go
+// in increasing order, each as the number of ids skipped since the
+// previous one.
+//   snapshot  tick, width, height, snake slots,
+//             per slot: length, 0 for a dead snake, else the head cell,
+//             the direction it last moved in, and then one byte per four
+//             segments from the neck to the tail, two bits each holding
+//             the direction from the previous segment,
+//             fruit count, fruit cells as gaps from the previous one
+//   tick      tick, flags (ARENA_CHECKSUM: a checksum ends the frame),
+//             deaths: count, ids,
+//             moves: count, per move id gap << 3 | direction << 1 | ate,
+//             fruits: count, cells,
+//             spawns: count, per spawn id gap, cell << 2 | direction,
+//             [arena_checksum of the board after the tick]
+// A cell is i * width + j.
+enum arena_frame_kind : std::uint8_t
+{
+    ARENA_SNAPSHOT = 'S',
+    ARENA_TICK = 'T'
+};
+
+enum arena_frame_flags : std::uint8_t
+{
+    ARENA_CHECKSUM = 1
+};
+
+std::size_t constexpr arena_frame_header_size{ 4 };
+
+// FNV-1a over the row-major cell plane, to check a spectator's copy.
+struct arena_checksum_t
+{
+    std::uint64_t value{ 0xCBF29CE484222325ull };
+
+    inline void add(field_base_t::cell_type const t_cell) noexcept
+    {
+        value ^= t_cell;
+        value *= 0x100000001B3ull;
+    }
+};
+
+// Append one whole frame, header included, to t_out.
+void encode_arena_snapshot(arena_simulation_t const& t_arena, std::uint64_t const t_tick,
+                           std::vector<std::uint8_t>& t_out);
+void encode_arena_tick(arena_simulation_t const& t_arena, std::uint64_t const t_tick,
+                       bool const t_checksum, std::vector<std::uint8_t>& t_out);
+
+// Payload length of the frame at t_data, or false if the header isn't all
+// there yet.
+bool peek_arena_frame(std::uint8_t const* t_data, std::size_t const t_size,
+                      std::size_t& t_payload_size) noexcept;
+
+// A spectator's copy of the arena, rebuilt from frames. It also keeps
+// where each head and tail were before the last tick, so a renderer can
+// slide them between tick frames instead of jumping once per tick.
+struct arena_view_t
+{
+public:
+    using cell_type = field_base_t::cell_type;
+
+    struct point_t
+    {
+        double i{ 0.0 };
+        double j{ 0.0 };
+    };
+
+private:
+    using body_t = ring_buffer_t<std::vector<position_t>>;
+
+    int m_width{ 0 };
+    int m_height{ 0 };
+    std::uint64_t m_tick{ 0 };
+    bool m_synced{ false };
+
+    std::vector<cell_type> m_cells;
+    std::vector<body_t> m_bodies;
+    std::vector<direction_type> m_direction;
+    // Whether the snake's head moved in the last tick, and where its tail
+    // was before it (the current tail if it didn't move).
+    std::vector<std::uint8_t> m_moved;
+    std::vector<position_t> m_old_tail;
+
+    inline cell_type& cell(position_t const& t_pos) noexcept
+    { return m_cells[std::size_t(t_pos.i) * m_width + t_pos.j]; }
+    inline bool on_board(position_t const& t_pos) const noexcept
+    { return is_inside(t_pos, m_width, m_height); }
+
+    void push_head(std::size_t const t_snake, position_t const& t_head);
+    bool apply_snapshot(std::uint8_t const* t_data, std::uint8_t const* t_end);
+    bool apply_tick(std::uint8_t const* t_data, std::uint8_t const* t_end);
+
+public:
+    arena_view_t() noexcept = default;
+    ~arena_view_t() noexcept = default;
+
+    // Applies one payload (the bytes after a frame header). Returns false,
+    // and stops being synced() until the next snapshot, if the payload is
+    // malformed, doesn't follow the previous tick or fails its checksum.
+    bool apply(std::uint8_t const* t_payload, std::size_t const t_size);
+
+    inline bool synced() const noexcept
+    { return m_synced; }
+    inline std::uint64_t tick() const noexcept
+    { return m_tick; }
+    inline int width() const noexcept
+    { return m_width; }
+    inline int height() const noexcept
+    { return m_height; }
+    // Row-major, width() * height() cells.
+    inline cell_type const* cells() const noexcept
+    { return m_cells.data(); }
+    std::uint64_t checksum() const noexcept;
+
+    inline std::size_t size() const noexcept
+    { return m_bodies.size(); }
+    inline bool is_alive(std::size_t const t_snake) const noexcept
+    { return !m_bodies[t_snake].empty(); }
+    inline std::size_t get_length(std::size_t const t_snake) const noexcept
+    { return m_bodies[t_snake].size(); }
+    inline position_t get_position(std::size_t const t_snake,
+                                   std::size_t const t_index) const noexcept
+    { return m_bodies[t_snake][t_index]; }
+
+    // Where t_snake's head and tail are drawn t_alpha of the way (0 to 1)
+    // from the previous tick to the latest; t_snake must be alive.
+    point_t head_at(std::size_t const t_snake, double const t_alpha) const noexcept;
+    point_t tail_at(std::size_t const t_snake, double const t_alpha) const noexcept;
+};
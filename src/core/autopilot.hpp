@@ -0,0 +1,567 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+
+// Plays the game by itself, for attract modes and soak tests: call
+// next_direction() where the keyboard would be read and pass the result to
+// step(). It walks a shortest path from the head to the fruit, found by a
+// breadth-first search around the snake, and keeps walking it while the
+// fruit stays where it is instead of searching again every tick.
+//
+// A greedy path eventually boxes the snake in, so on boards of at least
+// cycle_threshold cells that have a Hamiltonian cycle (one side even) the
+// snake moves along the cycle instead, skipping ahead where it can: a step
+// of the path, or else the neighbour furthest along, is taken only if it
+// lands past the head but short of both the tail and the fruit in cycle
+// order. The body then always lies along the cycle, so the snake can't
+// trap itself, and every tick brings the fruit closer.
+//
+// Without the cycle (odd by odd boards, small ones) a path is only taken
+// if the tail is still reachable from the head once the snake has walked
+// it and eaten; otherwise the snake follows its own tail, the long way
+// round, until a safe path opens up (or, to break a loop, until it has
+// followed the tail for a board's worth of ticks).
+//
+// Every search buffer is sized to the board at construction, so a query
+// allocates nothing.
+template<typename Field>
+struct autopilot_t
+{
+public:
+    static std::size_t constexpr default_cycle_threshold{ 64 };
+
+private:
+    template<typename T>
+    using buffer_type = typename Field::template buffer_type<T>;
+    using cell_type_t = typename Field::cell_type;
+
+    int m_width;
+    int m_height;
+    std::size_t m_cells;
+    std::size_t m_cycle_threshold;
+    bool m_has_cycle{ false };
+
+    // Position of every cell along the cycle.
+    buffer_type<int> m_cycle_index;
+
+    // A cell was reached by the current search iff its mark is m_search,
+    // so starting a search doesn't clear anything.
+    buffer_type<std::uint32_t> m_mark;
+    buffer_type<int> m_parent;
+    buffer_type<int> m_queue;
+    std::uint32_t m_search{ 0 };
+
+    // Body of the snake as it would be at the end of m_path, stamped the
+    // same way with m_projection.
+    buffer_type<std::uint32_t> m_projected;
+    std::uint32_t m_projection{ 0 };
+    // Ticks spent following the tail since the last meal. Following it can
+    // settle into a loop that never frees a safe path, so after a board's
+    // worth of ticks an unsafe path is taken anyway.
+    std::size_t m_chasing{ 0 };
+
+    // The path backwards, fruit first: the next step is
+    // m_path[m_path_left - 1].
+    buffer_type<int> m_path;
+    std::size_t m_path_left{ 0 };
+    int m_path_fruit{ -1 };
+
+    // Where the last direction handed out leads; anything else under the
+    // head means someone else steered or a new game started.
+    int m_expected{ -1 };
+    // Set once the body is known to lie in cycle order; kept true by
+    // following the cycle.
+    bool m_ordered{ false };
+    // Ticks to take cycle shortcuts before searching again after a path
+    // was refused, which bounds the searches on a big board to one per
+    // path length.
+    std::size_t m_cooldown{ 0 };
+    // The cell behind a one-cell snake: step() ignores a reversal even
+    // without a neck, so it is as good as a wall. -1 otherwise.
+    int m_behind{ -1 };
+
+    constexpr int index_of(position_t const& t_pos) const noexcept
+    { return t_pos.i * m_width + t_pos.j; }
+    constexpr position_t position_of(int const t_cell) const noexcept
+    { return { t_cell / m_width, t_cell % m_width }; }
+
+    // How far t_to is ahead of t_from along the cycle.
+    std::size_t cycle_distance(int const t_from, int const t_to) const noexcept
+    {
+        int const distance = m_cycle_index[t_to] - m_cycle_index[t_from];
+        return static_cast<std::size_t>(
+            distance < 0 ? distance + static_cast<int>(m_cells) : distance
+        );
+    }
+    // Row 0 left to right, then the other rows swept back and forth over
+    // every column but the first, which leads back up; transposed when
+    // only the width is even.
+    void build_cycle(bool const t_transposed) noexcept
+    {
+        int const rows = t_transposed ? m_width : m_height;
+        int const columns = t_transposed ? m_height : m_width;
+        int ordinal{ 0 };
+
+        auto const add = [this, t_transposed, &ordinal](int const t_row,
+                                                        int const t_column) {
+            int const cell = t_transposed
+                ? t_column * m_width + t_row
+                : t_row * m_width + t_column;
+
+            m_cycle_index[cell] = ordinal++;
+        };
+
+        for(int column = 0; column < columns; ++column) {
+            add(0, column);
+        }
+        for(int row = 1; row < rows; ++row) {
+            if(row % 2 == 1) {
+                for(int column = columns - 1; column >= 1; --column) {
+                    add(row, column);
+                }
+            }
+            else {
+                for(int column = 1; column < columns; ++column) {
+                    add(row, column);
+                }
+            }
+        }
+        for(int row = rows - 1; row >= 1; --row) {
+            add(row, 0);
+        }
+    }
+
+    // The body is in cycle order when walking it from the tail to the head
+    // goes forwards along the cycle for less than one lap.
+    template<typename Snake>
+    bool in_cycle_order(Snake const& t_snake) const noexcept
+    {
+        std::size_t span{ 0 };
+
+        for(std::size_t k = 0; k + 1 < t_snake.get_length(); ++k) {
+            span += this->cycle_distance(
+                this->index_of(t_snake.get_position(k + 1)),
+                this->index_of(t_snake.get_position(k))
+            );
+        }
+
+        return span < m_cells;
+    }
+
+    // Breadth-first search from t_head to t_fruit through cells the snake
+    // doesn't cover; fills m_path on success.
+    bool search(Field const& t_field, int const t_head, int const t_fruit) noexcept
+    {
+        if(++m_search == 0) {
+            for(auto& mark : m_mark) {
+                mark = 0;
+            }
+            m_search = 1;
+        }
+
+        std::size_t begin{ 0 };
+        std::size_t end{ 0 };
+        bool found{ false };
+
+        m_mark[t_head] = m_search;
+        m_queue[end++] = t_head;
+
+        auto const visit = [&](int const t_from, int const t_i, int const t_j) {
+            int const cell = t_i * m_width + t_j;
+
+            if(m_mark[cell] == m_search || cell == m_behind ||
+               t_field.is_snake(t_i, t_j)) {
+                return;
+            }
+
+            m_mark[cell] = m_search;
+            m_parent[cell] = t_from;
+            m_queue[end++] = cell;
+            found = found || cell == t_fruit;
+        };
+
+        while(begin < end && !found) {
+            int const cell = m_queue[begin++];
+            position_t const pos = this->position_of(cell);
+
+            if(pos.i > 0) visit(cell, pos.i - 1, pos.j);
+            if(pos.i < m_height - 1) visit(cell, pos.i + 1, pos.j);
+            if(pos.j > 0) visit(cell, pos.i, pos.j - 1);
+            if(pos.j < m_width - 1) visit(cell, pos.i, pos.j + 1);
+        }
+
+        m_path_left = 0;
+        if(!found) {
+            return false;
+        }
+
+        for(int cell = t_fruit; cell != t_head; cell = m_parent[cell]) {
+            m_path[m_path_left++] = cell;
+        }
+        m_path_fruit = t_fruit;
+        return true;
+    }
+
+    // Breadth-first flood from t_source through the cells t_free accepts.
+    // A cell was reached iff its mark is m_search, and m_parent then holds
+    // its distance from t_source.
+    template<typename Free>
+    void flood(int const t_source, Free const& t_free) noexcept
+    {
+        if(++m_search == 0) {
+            for(auto& mark : m_mark) {
+                mark = 0;
+            }
+            m_search = 1;
+        }
+
+        std::size_t begin{ 0 };
+        std::size_t end{ 0 };
+
+        m_mark[t_source] = m_search;
+        m_parent[t_source] = 0;
+        m_queue[end++] = t_source;
+
+        auto const visit = [&](int const t_from, int const t_cell) {
+            if(m_mark[t_cell] == m_search || !t_free(t_cell)) {
+                return;
+            }
+
+            m_mark[t_cell] = m_search;
+            m_parent[t_cell] = m_parent[t_from] + 1;
+            m_queue[end++] = t_cell;
+        };
+
+        while(begin < end) {
+            int const cell = m_queue[begin++];
+            position_t const pos = this->position_of(cell);
+
+            if(pos.i > 0) visit(cell, cell - m_width);
+            if(pos.i < m_height - 1) visit(cell, cell + m_width);
+            if(pos.j > 0) visit(cell, cell - 1);
+            if(pos.j < m_width - 1) visit(cell, cell + 1);
+        }
+    }
+
+    // Whether, after walking the whole of m_path and eating the fruit at
+    // its end, some free neighbour of the new head still leads to the new
+    // tail. A path of L steps leaves the body as the L path cells followed
+    // by the old body's first length - L + 1 cells.
+    template<typename Snake>
+    bool path_is_safe(Snake const& t_snake) noexcept
+    {
+        std::size_t const length = t_snake.get_length();
+        std::size_t const steps = m_path_left;
+
+        if(length + 1 >= m_cells) {
+            // That meal fills the board and wins.
+            return true;
+        }
+
+        if(++m_projection == 0) {
+            for(auto& mark : m_projected) {
+                mark = 0;
+            }
+            m_projection = 1;
+        }
+
+        int tail{ -1 };
+        for(std::size_t k = 0; k < steps && k <= length; ++k) {
+            m_projected[m_path[k]] = m_projection;
+            tail = m_path[k];
+        }
+        for(std::size_t k = 0; k + steps <= length; ++k) {
+            tail = this->index_of(t_snake.get_position(k));
+            m_projected[tail] = m_projection;
+        }
+
+        this->flood(tail, [this](int const t_cell) {
+            return m_projected[t_cell] != m_projection;
+        });
+
+        position_t const head = this->position_of(m_path[0]);
+        for(int d = UP; d <= RIGHT; ++d) {
+            position_t const next = neighbour(head, static_cast<direction_type>(d));
+            if(next.i >= 0 && next.i < m_height && next.j >= 0 && next.j < m_width &&
+               m_mark[this->index_of(next)] == m_search &&
+               m_projected[this->index_of(next)] != m_projection) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The free neighbour, other than the fruit, from which the tail is
+    // furthest but still reachable, or -1 if there is none.
+    template<typename Snake>
+    int tail_step(Field const& t_field, Snake const& t_snake,
+                  int const t_head, int const t_fruit) noexcept
+    {
+        if(t_snake.get_length() < 2) {
+            return -1;
+        }
+
+        this->flood(this->index_of(t_snake.get_tail_position()),
+            [this, &t_field](int const t_cell) {
+                position_t const pos = this->position_of(t_cell);
+                return !t_field.is_snake(pos.i, pos.j);
+            }
+        );
+
+        position_t const head = this->position_of(t_head);
+        int best{ -1 };
+        int best_distance{ -1 };
+
+        for(int d = UP; d <= RIGHT; ++d) {
+            position_t const next = neighbour(head, static_cast<direction_type>(d));
+            if(t_field.at(next.i, next.j) == Field::ERROR) {
+                continue;
+            }
+
+            int const cell = this->index_of(next);
+            if(cell == t_fruit || cell == m_behind || m_mark[cell] != m_search ||
+               t_field.is_snake(next.i, next.j)) {
+                continue;
+            }
+
+            if(m_parent[cell] > best_distance) {
+                best = cell;
+                best_distance = m_parent[cell];
+            }
+        }
+
+        return best;
+    }
+
+    // Next cell on a path to t_fruit that keeps the tail reachable, else
+    // on the way round to the tail; -1 if neither exists.
+    template<typename Snake>
+    int safe_step(Field const& t_field, Snake const& t_snake,
+                  int const t_head, int const t_fruit) noexcept
+    {
+        bool const reusable = m_path_left > 0 && m_path_fruit == t_fruit;
+
+        if(reusable || (this->search(t_field, t_head, t_fruit) &&
+                        (m_chasing >= m_cells || this->path_is_safe(t_snake)))) {
+            m_chasing = 0;
+            return m_path[--m_path_left];
+        }
+
+        m_path_left = 0;
+        ++m_chasing;
+        return this->tail_step(t_field, t_snake, t_head, t_fruit);
+    }
+
+    // Next cell on the way to t_fruit, or -1 if it can't be reached.
+    int path_step(Field const& t_field, int const t_head, int const t_fruit) noexcept
+    {
+        bool const reusable = m_path_left > 0 && m_path_fruit == t_fruit;
+
+        if(!reusable && !this->search(t_field, t_head, t_fruit)) {
+            return -1;
+        }
+
+        return m_path[--m_path_left];
+    }
+
+    // How far along the cycle the head may move this tick. Stopping short
+    // of the tail, t_room ahead, keeps the body in cycle order, and not
+    // passing the fruit, t_to_fruit ahead, makes progress. A jump of more
+    // than one cell leaves free cells behind the head that only come back
+    // once the tail has passed them, so jumps stop once the snake covers
+    // half the board or would leave fewer free cells ahead of the head
+    // than behind it.
+    std::size_t reach(std::size_t const t_length, std::size_t const t_room,
+                      std::size_t const t_to_fruit) const noexcept
+    {
+        std::size_t const ahead = t_room - 1;
+        std::size_t const behind = m_cells - t_length - ahead;
+        std::size_t jump{ 1 };
+
+        if(2 * t_length < m_cells && ahead > behind) {
+            jump = std::max<std::size_t>(1, (ahead - behind) / 2);
+        }
+
+        return std::min({ ahead, t_to_fruit, jump });
+    }
+
+    // The neighbour furthest along the cycle within t_reach; the successor
+    // qualifies unless it is m_behind or t_reach is 0, so this only fails
+    // for a one-cell snake or a doomed one.
+    int shortcut_step(Field const& t_field, int const t_head,
+                      std::size_t const t_reach) const noexcept
+    {
+        position_t const head = this->position_of(t_head);
+        int best{ -1 };
+        std::size_t best_distance{ 0 };
+
+        for(int d = UP; d <= RIGHT; ++d) {
+            position_t const next = neighbour(head, static_cast<direction_type>(d));
+            int const cell = this->index_of(next);
+            if(t_field.at(next.i, next.j) == Field::ERROR ||
+               t_field.is_snake(next.i, next.j) || cell == m_behind) {
+                continue;
+            }
+
+            std::size_t const distance = this->cycle_distance(t_head, cell);
+            if(distance <= t_reach && distance > best_distance) {
+                best = cell;
+                best_distance = distance;
+            }
+        }
+
+        return best;
+    }
+
+    // With the fruit out of reach: the free neighbour with the most free
+    // neighbours of its own, or -1 if the snake is boxed in.
+    int escape_step(Field const& t_field, int const t_head) const noexcept
+    {
+        position_t const head = this->position_of(t_head);
+        int best{ -1 };
+        int best_room{ -1 };
+
+        for(int d = UP; d <= RIGHT; ++d) {
+            position_t const next = neighbour(head, static_cast<direction_type>(d));
+            if(t_field.at(next.i, next.j) == Field::ERROR ||
+               t_field.is_snake(next.i, next.j) || this->index_of(next) == m_behind) {
+                continue;
+            }
+
+            int room{ 0 };
+            for(int e = UP; e <= RIGHT; ++e) {
+                position_t const around = neighbour(next, static_cast<direction_type>(e));
+                cell_type_t const cell = t_field.at(around.i, around.j);
+                room += cell == Field::EMPTY || cell == Field::FRUIT;
+            }
+
+            if(room > best_room) {
+                best = this->index_of(next);
+                best_room = room;
+            }
+        }
+
+        return best;
+    }
+
+public:
+    autopilot_t() = delete;
+    explicit autopilot_t(Field const& t_field,
+                         std::size_t const t_cycle_threshold = default_cycle_threshold)
+        : m_width{ t_field.width() }
+        , m_height{ t_field.height() }
+        , m_cells{ std::size_t(t_field.width()) * t_field.height() }
+        , m_cycle_threshold{ t_cycle_threshold }
+        , m_cycle_index{ t_field.template make_buffer<int>() }
+        , m_mark{ t_field.template make_buffer<std::uint32_t>() }
+        , m_parent{ t_field.template make_buffer<int>() }
+        , m_queue{ t_field.template make_buffer<int>() }
+        , m_projected{ t_field.template make_buffer<std::uint32_t>() }
+        , m_path{ t_field.template make_buffer<int>() }
+    {
+        if(m_width >= 2 && m_height >= 2) {
+            if(m_height % 2 == 0) {
+                this->build_cycle(false);
+                m_has_cycle = true;
+            }
+            else if(m_width % 2 == 0) {
+                this->build_cycle(true);
+                m_has_cycle = true;
+            }
+        }
+    }
+    ~autopilot_t() noexcept = default;
+
+    // Forgets the path and what it knew about the snake, for a new game
+    // on the same board.
+    void reset() noexcept
+    {
+        m_path_left = 0;
+        m_expected = -1;
+        m_ordered = false;
+        m_cooldown = 0;
+        m_chasing = 0;
+    }
+
+    // Whether the snake follows the Hamiltonian cycle on this board.
+    constexpr bool follows_cycle() const noexcept
+    { return m_has_cycle && m_cells >= m_cycle_threshold; }
+
+    // The direction to steer t_simulation (a simulation_t on a board of
+    // the size this autopilot was made for) into on its next step().
+    template<typename Simulation>
+    direction_type next_direction(Simulation const& t_simulation) noexcept
+    {
+        Field const& field = t_simulation.get_field();
+        auto const& snake = t_simulation.get_snake();
+        int const head = this->index_of(snake.get_head_position());
+        int const fruit = this->index_of(t_simulation.get_fruit().get_position());
+        position_t const behind = neighbour(
+            snake.get_head_position(), opposite(t_simulation.get_direction())
+        );
+
+        m_behind = snake.get_length() == 1 && field.at(behind.i, behind.j) != Field::ERROR
+            ? this->index_of(behind)
+            : -1;
+
+        if(head != m_expected) {
+            m_path_left = 0;
+            m_ordered = false;
+            m_cooldown = 0;
+            m_chasing = 0;
+        }
+
+        bool const cycle = this->follows_cycle() &&
+            (m_ordered || (m_ordered = this->in_cycle_order(snake)));
+
+        int target{ -1 };
+
+        if(cycle) {
+            int const tail = this->index_of(snake.get_tail_position());
+            std::size_t const room =
+                tail == head ? m_cells : this->cycle_distance(head, tail);
+            std::size_t const reach = this->reach(
+                snake.get_length(), room, this->cycle_distance(head, fruit)
+            );
+
+            // With no jump allowed the path could only agree with the
+            // cycle, so it isn't searched for.
+            if(m_cooldown > 0) {
+                --m_cooldown;
+            }
+            else if(reach > 1) {
+                target = this->path_step(field, head, fruit);
+            }
+            if(target >= 0 && this->cycle_distance(head, target) > reach) {
+                m_cooldown = m_path_left + 1;
+                target = -1;
+            }
+            if(target < 0) {
+                // Leaving the path, if there was one.
+                m_path_left = 0;
+                target = this->shortcut_step(field, head, reach);
+            }
+        }
+        else {
+            target = this->safe_step(field, snake, head, fruit);
+        }
+
+        if(target < 0) {
+            target = this->escape_step(field, head);
+        }
+
+        m_expected = target;
+        if(target < 0) {
+            return t_simulation.get_direction();
+        }
+
+        return direction_between(
+            this->position_of(head), this->position_of(target)
+        );
+    }
+};
@@ -0,0 +1,213 @@
+#include "core/batch_kernel.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SNAKE_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(direction_type) == sizeof(std::int32_t),
+              "the kernels load directions as 32-bit lanes");
+
+namespace {
+    // The reference kernel, and the only one on targets other than x86-64.
+    void classify_scalar(batch_lanes_t const& t_lanes,
+                         direction_type const* t_actions,
+                         std::size_t const t_begin, std::size_t const t_end)
+    {
+        auto const width = static_cast<std::uint32_t>(t_lanes.width);
+        auto const height = static_cast<std::uint32_t>(t_lanes.height);
+
+        for(std::size_t game = t_begin; game < t_end; ++game) {
+            std::int32_t const current = t_lanes.direction[game];
+            std::int32_t const wanted = t_actions[game];
+            std::int32_t const direction = (wanted ^ 1) == current ? current : wanted;
+
+            std::int32_t const i = t_lanes.head_i[game] + row_step[direction];
+            std::int32_t const j = t_lanes.head_j[game] + column_step[direction];
+            bool const inside = static_cast<std::uint32_t>(i) < height
+                             && static_cast<std::uint32_t>(j) < width;
+
+            std::int32_t const target = i * t_lanes.width + j;
+            auto const cell = inside
+                ? t_lanes.cells[game * std::size_t(t_lanes.cells_per_game) + target]
+                : field_base_t::SNAKE_BODY;
+
+            bool const collided = (cell & field_base_t::SNAKE_MASK) != 0;
+
+            t_lanes.direction[game] = direction;
+            t_lanes.result[game] = static_cast<std::uint8_t>(
+                collided ? snake_base_t::COLLIDED
+                         : cell == field_base_t::FRUIT ? snake_base_t::ATE
+                                                       : snake_base_t::MOVED
+            );
+            if(!collided) {
+                t_lanes.head_i[game] = i;
+                t_lanes.head_j[game] = j;
+                t_lanes.target[game] = target;
+            }
+        }
+    }
+
+#if defined(SNAKE_HAS_AVX2_KERNEL)
+    // Eight games per iteration in 32-bit lanes; the target cells come in
+    // through one masked gather, so cells off the board are never read.
+    // The gather starts from the block's first board, so each lane only
+    // adds lane * cells_per_game + target to it.
+    //
+    // Each lane loads 4 bytes at its target cell. The 3 bytes past it are
+    // the rest of this board, the next game's board, or the 3 bytes of
+    // padding after the last board, so the load stays inside the cell
+    // buffer; byte_mask then drops them.
+    __attribute__((target("avx2")))
+    void classify_avx2(batch_lanes_t const& t_lanes,
+                       direction_type const* t_actions,
+                       std::size_t const t_begin, std::size_t const t_end)
+    {
+        __m256i const one = _mm256_set1_epi32(1);
+        __m256i const minus_one = _mm256_set1_epi32(-1);
+        __m256i const width = _mm256_set1_epi32(t_lanes.width);
+        __m256i const height = _mm256_set1_epi32(t_lanes.height);
+        __m256i const cells_per_game = _mm256_set1_epi32(t_lanes.cells_per_game);
+        __m256i const byte_mask = _mm256_set1_epi32(0xFF);
+        __m256i const snake_mask = _mm256_set1_epi32(field_base_t::SNAKE_MASK);
+        __m256i const fruit = _mm256_set1_epi32(field_base_t::FRUIT);
+        __m256i const lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i const row_steps = _mm256_setr_epi32(
+            row_step[UP], row_step[DOWN], row_step[LEFT], row_step[RIGHT], 0, 0, 0, 0
+        );
+        __m256i const column_steps = _mm256_setr_epi32(
+            column_step[UP], column_step[DOWN], column_step[LEFT], column_step[RIGHT], 0, 0, 0, 0
+        );
+        __m256i const ate = _mm256_set1_epi32(snake_base_t::ATE);
+        __m256i const collided_result = _mm256_set1_epi32(snake_base_t::COLLIDED);
+        __m256i const result_bytes = _mm256_setr_epi8(
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+        );
+
+        std::size_t game = t_begin;
+
+        for(; game + 8 <= t_end; game += 8) {
+            auto* const direction_ptr = reinterpret_cast<__m256i*>(t_lanes.direction + game);
+            auto* const head_i_ptr = reinterpret_cast<__m256i*>(t_lanes.head_i + game);
+            auto* const head_j_ptr = reinterpret_cast<__m256i*>(t_lanes.head_j + game);
+
+            __m256i const current = _mm256_loadu_si256(direction_ptr);
+            __m256i const wanted = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(t_actions + game)
+            );
+            __m256i const reversal = _mm256_cmpeq_epi32(_mm256_xor_si256(wanted, one), current);
+            __m256i const direction = _mm256_blendv_epi8(wanted, current, reversal);
+
+            __m256i const old_i = _mm256_loadu_si256(head_i_ptr);
+            __m256i const old_j = _mm256_loadu_si256(head_j_ptr);
+            __m256i const i = _mm256_add_epi32(
+                old_i, _mm256_permutevar8x32_epi32(row_steps, direction)
+            );
+            __m256i const j = _mm256_add_epi32(
+                old_j, _mm256_permutevar8x32_epi32(column_steps, direction)
+            );
+
+            __m256i const inside = _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi32(i, minus_one),
+                                 _mm256_cmpgt_epi32(j, minus_one)),
+                _mm256_and_si256(_mm256_cmpgt_epi32(height, i),
+                                 _mm256_cmpgt_epi32(width, j))
+            );
+
+            __m256i const target = _mm256_add_epi32(_mm256_mullo_epi32(i, width), j);
+            auto const* cells = reinterpret_cast<int const*>(
+                t_lanes.cells + game * std::size_t(t_lanes.cells_per_game)
+            );
+            __m256i const index = _mm256_add_epi32(
+                _mm256_mullo_epi32(lane, cells_per_game), target
+            );
+            __m256i const cell = _mm256_and_si256(
+                _mm256_mask_i32gather_epi32(snake_mask, cells, index, inside, 1),
+                byte_mask
+            );
+
+            __m256i const collided = _mm256_cmpeq_epi32(
+                _mm256_and_si256(cell, snake_mask), snake_mask
+            );
+            __m256i const eaten = _mm256_cmpeq_epi32(cell, fruit);
+            __m256i const result = _mm256_blendv_epi8(
+                _mm256_and_si256(eaten, ate), collided_result, collided
+            );
+
+            _mm256_storeu_si256(direction_ptr, direction);
+            _mm256_storeu_si256(head_i_ptr, _mm256_blendv_epi8(i, old_i, collided));
+            _mm256_storeu_si256(head_j_ptr, _mm256_blendv_epi8(j, old_j, collided));
+            _mm256_maskstore_epi32(
+                reinterpret_cast<int*>(t_lanes.target + game),
+                _mm256_xor_si256(collided, minus_one), target
+            );
+
+            __m256i const packed = _mm256_shuffle_epi8(result, result_bytes);
+            auto const low = static_cast<std::uint32_t>(
+                _mm_cvtsi128_si32(_mm256_castsi256_si128(packed))
+            );
+            auto const high = static_cast<std::uint32_t>(
+                _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1))
+            );
+            for(int k = 0; k < 4; ++k) {
+                t_lanes.result[game + k] = static_cast<std::uint8_t>(low >> (8 * k));
+                t_lanes.result[game + 4 + k] = static_cast<std::uint8_t>(high >> (8 * k));
+            }
+        }
+
+        classify_scalar(t_lanes, t_actions, game, t_end);
+    }
+#endif
+}
+
+bool is_kernel_supported(batch_kernel_type const t_kernel) noexcept
+{
+    switch(t_kernel) {
+        case SCALAR_KERNEL:
+            return true;
+#if defined(SNAKE_HAS_AVX2_KERNEL)
+        case AVX2_KERNEL:
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        default:
+            return false;
+    }
+}
+
+batch_kernel_type best_batch_kernel() noexcept
+{
+    static batch_kernel_type const best =
+        is_kernel_supported(AVX2_KERNEL) ? AVX2_KERNEL : SCALAR_KERNEL;
+    return best;
+}
+
+std::size_t max_kernel_cells(batch_kernel_type const t_kernel) noexcept
+{
+    std::size_t constexpr max_index{ 0x7FFFFFFF };
+
+    switch(t_kernel) {
+        case AVX2_KERNEL: return max_index / 8;
+        default: return max_index;
+    }
+}
+
+classify_fn get_classify_kernel(batch_kernel_type const t_kernel) noexcept
+{
+#if defined(SNAKE_HAS_AVX2_KERNEL)
+    if(t_kernel == AVX2_KERNEL && is_kernel_supported(AVX2_KERNEL)) {
+        return classify_avx2;
+    }
+#else
+    (void)t_kernel;
+#endif
+    return classify_scalar;
+}
+
+char const* get_kernel_name(batch_kernel_type const t_kernel) noexcept
+{
+    switch(t_kernel) {
+        case AVX2_KERNEL: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+#include "core/tick_delta.hpp"
+
+// The data-parallel half of a batched tick: for every game, apply the turn
+// (ignoring reversals), advance the head, and classify the move from the
+// bounds and the target cell — collided, ate or moved — before any board
+// is touched. Writing the results back stays scalar (see
+// batch_simulation_t::apply).
+//
+// All per-game arrays are indexed by game; cells holds cells_per_game
+// entries per game and must be readable 3 bytes past its end, since the
+// AVX2 kernel loads each target cell as a 32-bit word. Only the low byte
+// of that word is used.
+struct batch_lanes_t
+{
+    std::int32_t* direction{ nullptr };
+    std::int32_t* head_i{ nullptr };
+    std::int32_t* head_j{ nullptr };
+    std::int32_t* target{ nullptr };
+    std::uint8_t* result{ nullptr };
+    field_base_t::cell_type const* cells{ nullptr };
+
+    std::int32_t width{ 0 };
+    std::int32_t height{ 0 };
+    std::int32_t cells_per_game{ 0 };
+};
+
+// Steps games [t_begin, t_end): direction, head_i/head_j and target get
+// the new head (left unchanged on a collision) and result gets a
+// snake_base_t::move_result.
+using classify_fn = void (*)(batch_lanes_t const& t_lanes,
+                             direction_type const* t_actions,
+                             std::size_t t_begin, std::size_t t_end);
+
+enum batch_kernel_type
+{
+    SCALAR_KERNEL = 0,
+    AVX2_KERNEL
+};
+
+bool is_kernel_supported(batch_kernel_type const t_kernel) noexcept;
+// The widest kernel this CPU runs, checked once at run time.
+batch_kernel_type best_batch_kernel() noexcept;
+// Largest board, in cells, that t_kernel can step: every kernel keeps a
+// target cell in 32 bits, and the vector kernels also reach all eight
+// games of a block through 32-bit offsets from its first board.
+std::size_t max_kernel_cells(batch_kernel_type const t_kernel) noexcept;
+// Falls back to the scalar kernel when t_kernel is not supported.
+classify_fn get_classify_kernel(batch_kernel_type const t_kernel) noexcept;
+char const* get_kernel_name(batch_kernel_type const t_kernel) noexcept;
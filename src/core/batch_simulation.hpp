@@ -0,0 +1,364 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "core/batch_kernel.hpp"
+#include "core/extent.hpp"
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+#include "core/random.hpp"
+#include "core/snake.hpp"
+#include "core/thread_pool.hpp"
+#include "core/trace.hpp"
+
+// Many independent games on boards of one size, stored structure-of-
+// arrays: every per-cell plane (cells, snake body, free-cell index) is one
+// contiguous buffer with game k at [k * cells, (k + 1) * cells), and every
+// per-game scalar lives in its own vector. step() advances all games by a
+// tick from one array of directions. As with basic_game_field_t, the
+// board size comes from an extent: batch_simulation_t<W, H> fixes it at
+// compile time, dynamic_batch_simulation_t takes it at run time.
+//
+// Each tick first runs a classify kernel (see batch_kernel.hpp) over a
+// whole range of games, vectorized where the CPU allows, and then writes
+// the outcomes back into the boards one game at a time.
+//
+// The rules and the order of every RNG draw match simulation_t exactly, so
+// game k replays like simulation_t{ get_seed(k) } fed the same directions.
+// A game that ends is reset on the spot with the next seed of its stream;
+// get_done(k) and get_result(k) tell what its last tick did.
+template<typename Extent>
+struct batch_index_type
+{ using type = std::uint32_t; };
+
+// Wide enough for any cell index or the length of a snake filling the board.
+template<int Width, int Height>
+struct batch_index_type<fixed_extent_t<Width, Height>>
+{
+    using type = std::conditional_t<
+        std::size_t{ Width } * Height < 0xFFFF, std::uint16_t, std::uint32_t
+    >;
+};
+
+template<typename Extent>
+struct basic_batch_simulation_t
+{
+public:
+    using cell_type = field_base_t::cell_type;
+    using move_result = snake_base_t::move_result;
+    using index_type = typename batch_index_type<Extent>::type;
+
+private:
+    Extent m_extent;
+    std::size_t m_count{ 0 };
+    std::uint64_t m_base_seed{ 0 };
+
+    // Three bytes of padding past the last board keep the 32-bit cell
+    // loads of the AVX2 kernel inside the buffer.
+    std::vector<cell_type> m_cells;
+    std::vector<index_type> m_body;
+    std::vector<index_type> m_free_cells;
+    std::vector<index_type> m_free_slots;
+
+    std::vector<std::int32_t> m_head_i;
+    std::vector<std::int32_t> m_head_j;
+    std::vector<std::int32_t> m_target;
+    std::vector<index_type> m_head_slot;
+    std::vector<index_type> m_length;
+    std::vector<index_type> m_free_count;
+    std::vector<index_type> m_fruit;
+    std::vector<std::int32_t> m_direction;
+    std::vector<std::uint8_t> m_result;
+    std::vector<std::uint8_t> m_done;
+    std::vector<std::uint32_t> m_episode;
+    std::vector<std::uint32_t> m_ticks;
+    std::vector<std::uint64_t> m_seed;
+    std::vector<rng_engine_t> m_rng;
+
+    batch_kernel_type m_kernel{ SCALAR_KERNEL };
+    classify_fn m_classify{ get_classify_kernel(SCALAR_KERNEL) };
+
+    inline std::size_t base(std::size_t const t_game) const noexcept
+    { return t_game * this->cell_count(); }
+
+    void add_free_cell(std::size_t const t_game, index_type const t_index) noexcept
+    {
+        std::size_t const offset = this->base(t_game);
+        index_type& count = m_free_count[t_game];
+
+        m_free_slots[offset + t_index] = count;
+        m_free_cells[offset + count++] = t_index;
+    }
+    void remove_free_cell(std::size_t const t_game, index_type const t_index) noexcept
+    {
+        std::size_t const offset = this->base(t_game);
+        index_type const slot = m_free_slots[offset + t_index];
+        index_type const last = m_free_cells[offset + --m_free_count[t_game]];
+
+        m_free_cells[offset + slot] = last;
+        m_free_slots[offset + last] = slot;
+    }
+
+    // Same draw as fruit_t::gen_new_position + update_field.
+    void place_fruit(std::size_t const t_game) noexcept
+    {
+        std::size_t const offset = this->base(t_game);
+        index_type const fruit = m_free_cells[
+            offset + random_below(m_rng[t_game], m_free_count[t_game])
+        ];
+
+        m_fruit[t_game] = fruit;
+        m_cells[offset + fruit] = cell_type::FRUIT;
+        this->remove_free_cell(t_game, fruit);
+    }
+
+    void apply(std::size_t const t_game, move_result const t_result) noexcept;
+
+public:
+    // Game k starts from seed t_base_seed + k; its e-th reset uses
+    // t_base_seed + k + e * t_count. A board may hold at most
+    // max_kernel_cells(SCALAR_KERNEL) cells.
+    basic_batch_simulation_t(std::size_t const t_count, std::uint64_t const t_base_seed,
+                             Extent const& t_extent = Extent{});
+    basic_batch_simulation_t(basic_batch_simulation_t const&) = delete;
+    basic_batch_simulation_t& operator=(basic_batch_simulation_t const&) = delete;
+    ~basic_batch_simulation_t() noexcept = default;
+
+    // Starts a fresh episode of t_game from t_seed.
+    void reset(std::size_t const t_game, std::uint64_t const t_seed) noexcept;
+    // Starts every game over, as if constructed with t_base_seed.
+    void restart(std::uint64_t const t_base_seed) noexcept
+    {
+        m_base_seed = t_base_seed;
+
+        for(std::size_t game = 0; game < m_count; ++game) {
+            m_episode[game] = 0;
+            m_result[game] = snake_base_t::MOVED;
+            m_done[game] = 0;
+            this->reset(game, m_base_seed + game);
+        }
+    }
+
+    // Steps games [t_begin, t_end); t_directions is indexed by game.
+    void step(direction_type const* t_directions,
+              std::size_t const t_begin, std::size_t const t_end) noexcept;
+    void step(direction_type const* t_directions) noexcept
+    { this->step(t_directions, 0, m_count); }
+    // Spreads the games over t_pool, t_grain games per chunk.
+    void step(direction_type const* t_directions, thread_pool_t& t_pool,
+              std::size_t const t_grain = 256)
+    {
+        t_pool.parallel_for(0, m_count, t_grain,
+            [this, t_directions](std::size_t const t_begin, std::size_t const t_end) {
+                this->step(t_directions, t_begin, t_end);
+            }
+        );
+    }
+
+    inline std::size_t size() const noexcept
+    { return m_count; }
+    constexpr int width() const noexcept
+    { return m_extent.width(); }
+    constexpr int height() const noexcept
+    { return m_extent.height(); }
+    // Cells per board.
+    constexpr std::size_t cell_count() const noexcept
+    { return std::size_t(m_extent.width()) * m_extent.height(); }
+
+    // Forces a kernel, e.g. to compare against SCALAR_KERNEL; falls back
+    // to scalar when the CPU lacks t_kernel or the boards are too big for
+    // it. The results never differ.
+    void set_kernel(batch_kernel_type const t_kernel) noexcept
+    {
+        m_kernel = is_kernel_supported(t_kernel) &&
+                   this->cell_count() <= max_kernel_cells(t_kernel)
+                 ? t_kernel : SCALAR_KERNEL;
+        m_classify = get_classify_kernel(m_kernel);
+    }
+    inline batch_kernel_type get_kernel() const noexcept
+    { return m_kernel; }
+
+    // Row-major cell plane of t_game, cell_count() entries long.
+    inline cell_type const* get_cells(std::size_t const t_game) const noexcept
+    { return m_cells.data() + this->base(t_game); }
+    inline std::size_t get_length(std::size_t const t_game) const noexcept
+    { return m_length[t_game]; }
+    inline direction_type get_direction(std::size_t const t_game) const noexcept
+    { return static_cast<direction_type>(m_direction[t_game]); }
+    inline position_t get_head(std::size_t const t_game) const noexcept
+    { return { m_head_i[t_game], m_head_j[t_game] }; }
+    // Meaningless while the board is full (the episode has just been won).
+    inline position_t get_fruit(std::size_t const t_game) const noexcept
+    { return { m_fruit[t_game] / this->width(), m_fruit[t_game] % this->width() }; }
+    inline move_result get_result(std::size_t const t_game) const noexcept
+    { return static_cast<move_result>(m_result[t_game]); }
+    // Whether the last step ended an episode (t_game has since been reset).
+    inline bool get_done(std::size_t const t_game) const noexcept
+    { return m_done[t_game] != 0; }
+    inline std::uint32_t get_episode(std::size_t const t_game) const noexcept
+    { return m_episode[t_game]; }
+    inline std::uint32_t get_ticks(std::size_t const t_game) const noexcept
+    { return m_ticks[t_game]; }
+    inline std::uint64_t get_seed(std::size_t const t_game) const noexcept
+    { return m_seed[t_game]; }
+};
+
+template<typename Extent>
+basic_batch_simulation_t<Extent>::basic_batch_simulation_t(std::size_t const t_count,
+                                                           std::uint64_t const t_base_seed,
+                                                           Extent const& t_extent)
+    : m_extent{ t_extent }
+    , m_count{ t_count }
+    , m_base_seed{ t_base_seed }
+    , m_cells(t_count * this->cell_count() + 3)
+    , m_body(t_count * this->cell_count())
+    , m_free_cells(t_count * this->cell_count())
+    , m_free_slots(t_count * this->cell_count())
+    , m_head_i(t_count)
+    , m_head_j(t_count)
+    , m_target(t_count)
+    , m_head_slot(t_count)
+    , m_length(t_count)
+    , m_free_count(t_count)
+    , m_fruit(t_count)
+    , m_direction(t_count)
+    , m_result(t_count)
+    , m_done(t_count)
+    , m_episode(t_count)
+    , m_ticks(t_count)
+    , m_seed(t_count)
+    , m_rng(t_count)
+{
+    this->set_kernel(best_batch_kernel());
+
+    for(std::size_t game = 0; game < m_count; ++game) {
+        this->reset(game, m_base_seed + game);
+    }
+}
+
+template<typename Extent>
+void basic_batch_simulation_t<Extent>::reset(std::size_t const t_game,
+                                              std::uint64_t const t_seed) noexcept
+{
+    std::size_t const offset = this->base(t_game);
+
+    m_seed[t_game] = t_seed;
+    m_rng[t_game].seed(t_seed);
+    m_free_count[t_game] = 0;
+
+    for(std::size_t index = 0; index < this->cell_count(); ++index) {
+        m_cells[offset + index] = cell_type::EMPTY;
+        this->add_free_cell(t_game, static_cast<index_type>(index));
+    }
+
+    auto const head = static_cast<index_type>(
+        (this->height() / 2 - 1) * this->width() + (this->width() / 2 - 1)
+    );
+
+    m_head_slot[t_game] = 0;
+    m_body[offset] = head;
+    m_length[t_game] = 1;
+    m_cells[offset + head] = cell_type::SNAKE_HEAD;
+    this->remove_free_cell(t_game, head);
+    m_head_i[t_game] = this->height() / 2 - 1;
+    m_head_j[t_game] = this->width() / 2 - 1;
+
+    this->place_fruit(t_game);
+
+    m_direction[t_game] = UP;
+    m_ticks[t_game] = 0;
+}
+
+template<typename Extent>
+void basic_batch_simulation_t<Extent>::apply(std::size_t const t_game,
+                                              move_result const t_result) noexcept
+{
+    if(t_result == snake_base_t::COLLIDED) {
+        return;
+    }
+
+    std::size_t const offset = this->base(t_game);
+    index_type const head_slot = m_head_slot[t_game];
+    index_type const head = m_body[offset + head_slot];
+    auto const target = static_cast<index_type>(m_target[t_game]);
+
+    // Grow at the head first and only then drop the tail, as snake_t does,
+    // so the free-cell index sees the same sequence of updates.
+    index_type const new_slot = head_slot == 0
+        ? static_cast<index_type>(this->cell_count() - 1)
+        : static_cast<index_type>(head_slot - 1);
+
+    m_cells[offset + head] = cell_type::SNAKE_BODY;
+    m_cells[offset + target] = cell_type::SNAKE_HEAD;
+    if(t_result == snake_base_t::MOVED) {
+        this->remove_free_cell(t_game, target);
+    }
+    m_body[offset + new_slot] = target;
+    m_head_slot[t_game] = new_slot;
+
+    if(t_result == snake_base_t::ATE) {
+        ++m_length[t_game];
+        return;
+    }
+
+    std::size_t tail_slot = std::size_t{ new_slot } + m_length[t_game];
+    if(tail_slot >= this->cell_count()) {
+        tail_slot -= this->cell_count();
+    }
+    index_type const tail = m_body[offset + tail_slot];
+
+    m_cells[offset + tail] = cell_type::EMPTY;
+    this->add_free_cell(t_game, tail);
+}
+
+template<typename Extent>
+void basic_batch_simulation_t<Extent>::step(direction_type const* t_directions,
+                                             std::size_t const t_begin,
+                                             std::size_t const t_end) noexcept
+{
+    SNAKE_TRACE_ZONE("batch_simulation_t::step");
+
+    batch_lanes_t lanes{};
+    lanes.direction = m_direction.data();
+    lanes.head_i = m_head_i.data();
+    lanes.head_j = m_head_j.data();
+    lanes.target = m_target.data();
+    lanes.result = m_result.data();
+    lanes.cells = m_cells.data();
+    lanes.width = this->width();
+    lanes.height = this->height();
+    lanes.cells_per_game = static_cast<std::int32_t>(this->cell_count());
+
+    m_classify(lanes, t_directions, t_begin, t_end);
+
+    for(std::size_t game = t_begin; game < t_end; ++game) {
+        auto const result = static_cast<move_result>(m_result[game]);
+        this->apply(game, result);
+
+        bool done = result == snake_base_t::COLLIDED;
+        if(result == snake_base_t::ATE) {
+            if(m_free_count[game] == 0) {
+                done = true;
+            }
+            else {
+                this->place_fruit(game);
+            }
+        }
+
+        m_done[game] = done ? 1 : 0;
+        ++m_ticks[game];
+
+        if(done) {
+            ++m_episode[game];
+            this->reset(game, m_base_seed + game + m_episode[game] * m_count);
+        }
+    }
+}
+
+template<int Width, int Height>
+using batch_simulation_t = basic_batch_simulation_t<fixed_extent_t<Width, Height>>;
+
+using dynamic_batch_simulation_t = basic_batch_simulation_t<dynamic_extent_t>;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Shared by every board type so cells compare equal across them. The
+// values are chosen so that SNAKE_MASK is set exactly for the two snake
+// cells, which turns the collision check into a single bit test.
+struct field_base_t
+{
+    enum cell_type : std::uint8_t
+    {
+        EMPTY = 0,
+        FRUIT = 1,
+        SNAKE_HEAD = 2,
+        SNAKE_BODY = 3,
+        ERROR = 4
+    };
+
+    static std::size_t constexpr CELL_TYPE_COUNT{ 5 };
+
+    static std::uint8_t constexpr SNAKE_MASK{ 0x2 };
+    static std::uint8_t constexpr CELL_BITS{ 4 };
+};
+
+// How a board lays out its cells. Each policy names the element type of
+// the underlying buffer and how many cells one element holds; the board
+// allocates ceil(cells / cells_per_element) elements.
+
+struct byte_cells_t
+{
+    using element_type = field_base_t::cell_type;
+    static std::size_t constexpr cells_per_element{ 1 };
+
+    template<typename Buffer>
+    static constexpr field_base_t::cell_type get(Buffer const& t_buffer,
+                                                 std::size_t const t_index) noexcept
+    { return t_buffer[t_index]; }
+
+    template<typename Buffer>
+    static void set(Buffer& t_buffer, std::size_t const t_index,
+                    field_base_t::cell_type const t_cell) noexcept
+    { t_buffer[t_index] = t_cell; }
+};
+
+// Four bits per cell, sixteen cells per 64-bit word: a 4096x4096 board
+// takes 8 MB instead of 16 MB (bytes) or 64 MB (ints).
+struct packed_cells_t
+{
+    using element_type = std::uint64_t;
+    static std::size_t constexpr cells_per_element{
+        64 / field_base_t::CELL_BITS
+    };
+
+    template<typename Buffer>
+    static constexpr field_base_t::cell_type get(Buffer const& t_buffer,
+                                                 std::size_t const t_index) noexcept
+    {
+        auto const shift = (t_index % cells_per_element) * field_base_t::CELL_BITS;
+        return static_cast<field_base_t::cell_type>(
+            (t_buffer[t_index / cells_per_element] >> shift) & 0xF
+        );
+    }
+
+    template<typename Buffer>
+    static void set(Buffer& t_buffer, std::size_t const t_index,
+                    field_base_t::cell_type const t_cell) noexcept
+    {
+        auto const shift = (t_index % cells_per_element) * field_base_t::CELL_BITS;
+        std::uint64_t& word = t_buffer[t_index / cells_per_element];
+
+        word = (word & ~(std::uint64_t{ 0xF } << shift)) |
+               (std::uint64_t{ t_cell } << shift);
+    }
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Board dimensions and the buffers sized to them. fixed_extent_t bakes the
+// size into the type so every buffer is an inline std::array;
+// dynamic_extent_t takes the size at run time and makes each buffer one
+// heap block. A buffer holds one element per PerElement cells.
+
+template<int Width, int Height>
+struct fixed_extent_t
+{
+    static_assert(Width > 0 && Height > 0, "board must not be empty");
+
+    template<typename T, std::size_t PerElement = 1>
+    using buffer_type = std::array<
+        T, (std::size_t{ Width } * Height + PerElement - 1) / PerElement
+    >;
+
+    constexpr fixed_extent_t() noexcept = default;
+
+    static constexpr int width() noexcept
+    { return Width; }
+    static constexpr int height() noexcept
+    { return Height; }
+
+    template<typename T, std::size_t PerElement = 1>
+    static buffer_type<T, PerElement> make_buffer()
+    { return buffer_type<T, PerElement>{}; }
+};
+
+struct dynamic_extent_t
+{
+private:
+    int m_width{ 0 };
+    int m_height{ 0 };
+
+public:
+    template<typename T, std::size_t PerElement = 1>
+    using buffer_type = std::vector<T>;
+
+    dynamic_extent_t() noexcept = delete;
+    constexpr dynamic_extent_t(int const t_width, int const t_height) noexcept
+        : m_width{ t_width }
+        , m_height{ t_height }
+    {}
+
+    constexpr int width() const noexcept
+    { return m_width; }
+    constexpr int height() const noexcept
+    { return m_height; }
+
+    template<typename T, std::size_t PerElement = 1>
+    buffer_type<T, PerElement> make_buffer() const
+    {
+        return buffer_type<T, PerElement>(
+            (std::size_t(m_width) * m_height + PerElement - 1) / PerElement
+        );
+    }
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+#include "core/random.hpp"
+#include "core/trace.hpp"
+
+template<typename Field>
+struct fruit_t
+{
+private:
+    position_t m_position;
+    // Where m_position was in the free-cell index when it was drawn.
+    int m_slot{ 0 };
+
+    void gen_new_position(Field const& t_field, rng_engine_t& t_rng)
+    {
+        SNAKE_TRACE_ZONE("fruit_t::gen_new_position");
+
+        auto const free_cells =
+            static_cast<std::uint32_t>(t_field.free_cell_count());
+
+        m_slot = static_cast<int>(random_below(t_rng, free_cells));
+        m_position = t_field.free_cell(static_cast<std::size_t>(m_slot));
+    }
+
+    void update_field(Field& t_field)
+    { t_field.set(m_position.i, m_position.j, Field::cell_type::FRUIT); }
+
+public:
+    // Like snake_t, keeps no reference to the field or the engine.
+    fruit_t() noexcept = delete;
+    fruit_t(Field& t_field, rng_engine_t& t_rng)
+    {
+        this->gen_new_position(t_field, t_rng);
+        this->update_field(t_field);
+    }
+    ~fruit_t() noexcept = default;
+
+    // Returns false, leaving no fruit on the field, when the snake already
+    // covers every cell.
+    bool new_position(Field& t_field, rng_engine_t& t_rng)
+    {
+        if(t_field.free_cell_count() == 0) {
+            return false;
+        }
+
+        this->gen_new_position(t_field, t_rng);
+        this->update_field(t_field);
+        return true;
+    }
+
+    // Takes the latest fruit off the field again and puts the fruit back
+    // on t_previous, which the caller restores on the field itself.
+    void undo_new_position(Field& t_field, position_t const& t_previous,
+                           int const t_previous_slot) noexcept
+    {
+        t_field.revert(m_position.i, m_position.j, Field::cell_type::EMPTY, m_slot);
+        m_position = t_previous;
+        m_slot = t_previous_slot;
+    }
+
+    position_t get_position() const
+    { return m_position; }
+    int get_slot() const
+    { return m_slot; }
+};
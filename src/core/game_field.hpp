@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstddef>
+
+#include "core/cell_storage.hpp"
+#include "core/extent.hpp"
+#include "core/globals.hpp"
+#include "core/position.hpp"
+#include "core/trace.hpp"
+
+template<typename Extent, typename Cells = byte_cells_t>
+struct basic_game_field_t : field_base_t
+{
+public:
+    using extent_type = Extent;
+    using cell_storage_type = Cells;
+
+    template<typename T>
+    using buffer_type = typename Extent::template buffer_type<T>;
+
+private:
+    Extent m_extent;
+
+    // Row-major: cell (i, j) lives at i * width() + j.
+    typename Extent::template buffer_type<
+        typename Cells::element_type, Cells::cells_per_element
+    > m_field;
+
+    // Every EMPTY cell, stored densely as i * width + j, plus the slot of
+    // each cell inside that array (or -1), so cells can be added and
+    // swap-removed in O(1) and a random empty cell is a single draw.
+    buffer_type<int> m_free_cells;
+    buffer_type<int> m_free_slots;
+    std::size_t m_free_count{ 0 };
+
+    void add_free_cell(int const t_index) noexcept
+    {
+        m_free_slots[t_index] = static_cast<int>(m_free_count);
+        m_free_cells[m_free_count++] = t_index;
+    }
+    void remove_free_cell(int const t_index) noexcept
+    {
+        int const slot = m_free_slots[t_index];
+        int const last = m_free_cells[--m_free_count];
+
+        m_free_cells[slot] = last;
+        m_free_slots[last] = slot;
+        m_free_slots[t_index] = -1;
+    }
+
+public:
+    explicit basic_game_field_t(Extent const& t_extent = Extent{});
+    ~basic_game_field_t() noexcept = default;
+
+    constexpr int width() const noexcept
+    { return m_extent.width(); }
+    constexpr int height() const noexcept
+    { return m_extent.height(); }
+    constexpr Extent const& extent() const noexcept
+    { return m_extent; }
+
+    // A buffer with one element per cell, e.g. for the snake body.
+    template<typename T>
+    buffer_type<T> make_buffer() const
+    { return m_extent.template make_buffer<T>(); }
+
+    constexpr cell_type operator()(int const t_i, int const t_j) const
+    { return Cells::get(m_field, t_i * this->width() + t_j); }
+
+    // True for SNAKE_HEAD and SNAKE_BODY; (t_i, t_j) must be on the board.
+    constexpr bool is_snake(int const t_i, int const t_j) const
+    { return (this->operator()(t_i, t_j) & SNAKE_MASK) != 0; }
+
+    void set(int const t_i, int const t_j, cell_type const t_cell) noexcept
+    {
+        int const index = t_i * this->width() + t_j;
+        cell_type const cell = Cells::get(m_field, index);
+
+        if(cell == EMPTY && t_cell != EMPTY) {
+            this->remove_free_cell(index);
+        }
+        else if(cell != EMPTY && t_cell == EMPTY) {
+            this->add_free_cell(index);
+        }
+
+        Cells::set(m_field, index, t_cell);
+    }
+
+    // Slot of (t_i, t_j) in the free-cell index, -1 if it is not EMPTY.
+    constexpr int free_slot(int const t_i, int const t_j) const noexcept
+    { return m_free_slots[t_i * this->width() + t_j]; }
+    // Undoes the latest set() of (t_i, t_j), back to t_previous, leaving
+    // the free-cell index exactly as before, order included. Reverting
+    // several set() calls has to go newest first; t_slot is free_slot()
+    // from just before the set() being undone.
+    void revert(int const t_i, int const t_j, cell_type const t_previous,
+                int const t_slot) noexcept
+    {
+        int const index = t_i * this->width() + t_j;
+        cell_type const cell = Cells::get(m_field, index);
+
+        if(t_previous == EMPTY && cell != EMPTY && t_slot == static_cast<int>(m_free_count)) {
+            // It was the last entry, so nothing was moved into its slot.
+            m_free_cells[m_free_count] = index;
+            m_free_slots[index] = t_slot;
+            ++m_free_count;
+        }
+        else if(t_previous == EMPTY && cell != EMPTY) {
+            // remove_free_cell moved the last entry into t_slot.
+            int const moved = m_free_cells[t_slot];
+
+            m_free_cells[m_free_count] = moved;
+            m_free_slots[moved] = static_cast<int>(m_free_count);
+            ++m_free_count;
+
+            m_free_cells[t_slot] = index;
+            m_free_slots[index] = t_slot;
+        }
+        else if(t_previous != EMPTY && cell == EMPTY) {
+            --m_free_count;
+            m_free_slots[index] = -1;
+        }
+
+        Cells::set(m_field, index, t_previous);
+    }
+
+    constexpr std::size_t free_cell_count() const noexcept
+    { return m_free_count; }
+    // t_k must be less than free_cell_count(); the order is unspecified.
+    constexpr position_t free_cell(std::size_t const t_k) const noexcept
+    {
+        return {
+            m_free_cells[t_k] / this->width(),
+            m_free_cells[t_k] % this->width()
+        };
+    }
+
+    cell_type at(int const t_i, int const t_j) const
+    {
+        if(!is_inside({ t_i, t_j }, this->width(), this->height())) {
+            return ERROR;
+        }
+
+        return this->operator()(t_i, t_j);
+    }
+
+    // Window only needs clear_screen() and draw(position_t, cell_type); it
+    // decides how each kind of cell looks. This keeps the core free of any
+    // SDL dependency.
+    template<typename Window>
+    void draw(Window& t_window) const
+    {
+        SNAKE_TRACE_ZONE("game_field_t::draw");
+
+        t_window.clear_screen();
+
+        for(int i = 0; i < this->height(); ++i) {
+            for(int j = 0; j < this->width(); ++j) {
+                cell_type const cell = this->operator()(i, j);
+                if(cell != cell_type::EMPTY) {
+                    t_window.draw({ i, j }, cell);
+                }
+            }
+        }
+    }
+
+    // Repaints a single cell, background included, over whatever the
+    // window showed there before.
+    template<typename Window>
+    void draw_cell(Window& t_window, position_t const& t_pos) const
+    { t_window.draw(t_pos, this->operator()(t_pos.i, t_pos.j)); }
+};
+
+template<typename Extent, typename Cells>
+basic_game_field_t<Extent, Cells>::basic_game_field_t(Extent const& t_extent)
+    : m_extent{ t_extent }
+    , m_field{
+        t_extent.template make_buffer<
+            typename Cells::element_type, Cells::cells_per_element
+        >()
+    }
+    , m_free_cells{ t_extent.template make_buffer<int>() }
+    , m_free_slots{ t_extent.template make_buffer<int>() }
+{
+    int const cells = this->width() * this->height();
+
+    for(int index = 0; index < cells; ++index) {
+        Cells::set(m_field, index, cell_type::EMPTY);
+        this->add_free_cell(index);
+    }
+}
+
+template<int Width, int Height, typename Cells = byte_cells_t>
+using game_field_t = basic_game_field_t<fixed_extent_t<Width, Height>, Cells>;
+
+using dynamic_game_field_t = basic_game_field_t<dynamic_extent_t>;
+using packed_game_field_t =
+    basic_game_field_t<dynamic_extent_t, packed_cells_t>;
+
+using default_game_field_t =
+    game_field_t<globals::field_width, globals::field_height>;
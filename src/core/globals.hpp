@@ -0,0 +1,6 @@
+#pragma once
+
+namespace globals {
+    int constexpr field_width{ 10 };
+    int constexpr field_height{ 10 };
+}
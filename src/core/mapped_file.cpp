@@ -0,0 +1,89 @@
+#include "core/mapped_file.hpp"
+
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SNAKE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mapped_file_t::~mapped_file_t() noexcept
+{ this->close(); }
+
+void mapped_file_t::close() noexcept
+{
+#if defined(SNAKE_HAS_MMAP)
+    if(m_mapped) {
+        ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_fallback.clear();
+}
+
+bool mapped_file_t::open(char const* t_path)
+{
+    this->close();
+
+#if defined(SNAKE_HAS_MMAP)
+    int const descriptor = ::open(t_path, O_RDONLY);
+    if(descriptor < 0) {
+        return false;
+    }
+
+    struct stat status{};
+    if(::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(status.st_size);
+    if(m_size == 0) {
+        ::close(descriptor);
+        return true;
+    }
+
+    void* const address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if(address == MAP_FAILED) {
+        m_size = 0;
+        return false;
+    }
+
+    ::madvise(address, m_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<std::uint8_t const*>(address);
+    m_mapped = true;
+    return true;
+#else
+    std::FILE* file = std::fopen(t_path, "rb");
+    if(file == nullptr) {
+        return false;
+    }
+
+    std::uint8_t buffer[4096];
+    std::size_t read{ 0 };
+
+    while((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        m_fallback.insert(m_fallback.end(), buffer, buffer + read);
+    }
+
+    bool const failed = std::ferror(file) != 0;
+    std::fclose(file);
+
+    if(failed) {
+        m_fallback.clear();
+        return false;
+    }
+
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+    return true;
+#endif
+}
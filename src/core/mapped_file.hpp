@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A whole file mapped read-only into memory. Where mmap is not available
+// the file is read into a heap buffer instead, which keeps the interface
+// but not the zero-copy.
+struct mapped_file_t
+{
+private:
+    std::uint8_t const* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+    bool m_mapped{ false };
+    std::vector<std::uint8_t> m_fallback;
+
+    void close() noexcept;
+
+public:
+    mapped_file_t() noexcept = default;
+    mapped_file_t(mapped_file_t const&) = delete;
+    mapped_file_t& operator=(mapped_file_t const&) = delete;
+    ~mapped_file_t() noexcept;
+
+    // Returns false, leaving the object empty, if t_path can't be opened
+    // or mapped. An empty file opens fine with size() == 0.
+    bool open(char const* t_path);
+
+    inline std::uint8_t const* data() const noexcept
+    { return m_data; }
+    inline std::size_t size() const noexcept
+    { return m_size; }
+};
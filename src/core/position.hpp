@@ -0,0 +1,58 @@
+#pragma once
+
+struct position_t
+{
+    int i{ 0 };
+    int j{ 0 };
+
+    constexpr position_t() noexcept = default;
+    constexpr position_t(int const t_i, int const t_j) noexcept
+        : i(t_i)
+        , j(t_j)
+    {}
+    ~position_t() noexcept = default;
+};
+
+enum direction_type
+{
+    UP = 0,
+    DOWN,
+    LEFT,
+    RIGHT
+};
+
+// Row and column steps per direction, in direction_type order; shared by
+// every engine so a move is one lookup instead of a switch.
+inline constexpr int row_step[4]{ -1, 1, 0, 0 };
+inline constexpr int column_step[4]{ 0, 0, -1, 1 };
+
+static_assert((UP ^ 1) == DOWN && (LEFT ^ 1) == RIGHT,
+              "a direction's opposite is found by flipping bit 0");
+
+constexpr position_t neighbour(position_t const& t_pos,
+                               direction_type const t_direction) noexcept
+{
+    return { t_pos.i + row_step[t_direction], t_pos.j + column_step[t_direction] };
+}
+
+constexpr direction_type opposite(direction_type const t_direction) noexcept
+{ return static_cast<direction_type>(t_direction ^ 1); }
+
+// One unsigned comparison per axis, so a position just off any edge fails
+// the same branch as every other.
+constexpr bool is_inside(position_t const& t_pos, int const t_width,
+                         int const t_height) noexcept
+{
+    return static_cast<unsigned>(t_pos.i) < static_cast<unsigned>(t_height)
+        && static_cast<unsigned>(t_pos.j) < static_cast<unsigned>(t_width);
+}
+
+// The direction that leads from t_from to the adjacent cell t_to.
+constexpr direction_type direction_between(position_t const& t_from,
+                                           position_t const& t_to) noexcept
+{
+    if(t_to.i < t_from.i) return UP;
+    if(t_to.i > t_from.i) return DOWN;
+    if(t_to.j < t_from.j) return LEFT;
+    return RIGHT;
+}
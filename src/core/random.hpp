@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// Small-state engines modelling UniformRandomBitGenerator. The engine the
+// game uses is picked at compile time through SNAKE_RNG (see
+// CMakeLists.txt); every engine is seeded from a single 64-bit value so a
+// seed fully determines a game.
+
+inline std::uint64_t splitmix64(std::uint64_t& t_state) noexcept
+{
+    std::uint64_t z = (t_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct xoshiro256ss_t
+{
+public:
+    using result_type = std::uint64_t;
+
+private:
+    std::uint64_t m_state[4]{};
+
+    static constexpr std::uint64_t rotl(std::uint64_t const t_x,
+                                        int const t_k) noexcept
+    { return (t_x << t_k) | (t_x >> (64 - t_k)); }
+
+public:
+    explicit xoshiro256ss_t(std::uint64_t const t_seed = 0) noexcept
+    { this->seed(t_seed); }
+
+    void seed(std::uint64_t t_seed) noexcept
+    {
+        for(auto& word : m_state) {
+            word = splitmix64(t_seed);
+        }
+    }
+
+    static constexpr result_type min() noexcept
+    { return 0; }
+    static constexpr result_type max() noexcept
+    { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept
+    {
+        std::uint64_t const result = rotl(m_state[1] * 5, 7) * 9;
+        std::uint64_t const t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+};
+
+struct pcg32_t
+{
+public:
+    using result_type = std::uint32_t;
+
+private:
+    std::uint64_t m_state{ 0 };
+    std::uint64_t m_increment{ 1 };
+
+public:
+    explicit pcg32_t(std::uint64_t const t_seed = 0) noexcept
+    { this->seed(t_seed); }
+
+    void seed(std::uint64_t t_seed) noexcept
+    {
+        m_state = 0;
+        m_increment = (splitmix64(t_seed) << 1) | 1;
+        (*this)();
+        m_state += splitmix64(t_seed);
+        (*this)();
+    }
+
+    static constexpr result_type min() noexcept
+    { return 0; }
+    static constexpr result_type max() noexcept
+    { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept
+    {
+        std::uint64_t const old_state = m_state;
+        m_state = old_state * 6364136223846793005ull + m_increment;
+
+        auto const xorshifted = static_cast<std::uint32_t>(
+            ((old_state >> 18) ^ old_state) >> 27
+        );
+        auto const rot = static_cast<std::uint32_t>(old_state >> 59);
+
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+};
+
+#if defined(SNAKE_RNG_PCG32)
+using rng_engine_t = pcg32_t;
+#elif defined(SNAKE_RNG_MT19937)
+using rng_engine_t = std::mt19937_64;
+#else
+using rng_engine_t = xoshiro256ss_t;
+#endif
+
+// Uniform integer in [0, t_bound) using Lemire's multiply-and-reject
+// method. Unlike std::uniform_int_distribution, the sequence it produces is
+// the same on every standard library, which replays depend on.
+template<typename Engine>
+std::uint32_t random_below(Engine& t_rng, std::uint32_t const t_bound) noexcept
+{
+    static_assert(std::numeric_limits<typename Engine::result_type>::digits >= 32,
+                  "random_below needs at least 32 random bits per call");
+
+    auto const draw = [&t_rng]() {
+        int constexpr shift{
+            std::numeric_limits<typename Engine::result_type>::digits - 32
+        };
+        return static_cast<std::uint32_t>(t_rng() >> shift);
+    };
+
+    std::uint64_t product = std::uint64_t{ draw() } * t_bound;
+    auto low = static_cast<std::uint32_t>(product);
+
+    if(low < t_bound) {
+        std::uint32_t const threshold = (0u - t_bound) % t_bound;
+        while(low < threshold) {
+            product = std::uint64_t{ draw() } * t_bound;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+
+    return static_cast<std::uint32_t>(product >> 32);
+}
@@ -0,0 +1,101 @@
+#include "core/replay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+
+namespace {
+    std::uint8_t constexpr magic[4]{ 'S', 'N', 'K', 'R' };
+}
+
+void replay_t::encode(std::vector<std::uint8_t>& t_out) const
+{
+    t_out.insert(t_out.end(), std::begin(magic), std::end(magic));
+    t_out.push_back(version);
+
+    put_varint(t_out, seed);
+    put_varint(t_out, static_cast<std::uint64_t>(width));
+    put_varint(t_out, static_cast<std::uint64_t>(height));
+    put_varint(t_out, changes.size());
+
+    std::uint64_t previous{ 0 };
+    for(auto const& change : changes) {
+        put_varint(t_out, (change.tick - previous) << 2 | change.direction);
+        previous = change.tick;
+    }
+
+    put_varint(t_out, tick_count);
+}
+
+std::size_t replay_t::decode(std::uint8_t const* t_data, std::size_t const t_size,
+                             replay_t& t_replay)
+{
+    std::uint8_t const* cursor = t_data;
+    std::uint8_t const* const end = t_data + t_size;
+
+    if(t_size < sizeof(magic) + 1 ||
+       !std::equal(std::begin(magic), std::end(magic), cursor) ||
+       cursor[sizeof(magic)] != version) {
+        return 0;
+    }
+    cursor += sizeof(magic) + 1;
+
+    std::uint64_t count{ 0 };
+    if(!get_varint(cursor, end, t_replay.seed) ||
+       !get_varint(cursor, end, t_replay.width) ||
+       !get_varint(cursor, end, t_replay.height) ||
+       !get_varint(cursor, end, count) ||
+       t_replay.width < 2 || t_replay.height < 2 ||
+       t_replay.width > max_side || t_replay.height > max_side ||
+       std::size_t(t_replay.width) * std::size_t(t_replay.height) > max_cells ||
+       count > static_cast<std::uint64_t>(end - cursor)) {
+        return 0;
+    }
+
+    t_replay.changes.clear();
+    t_replay.changes.reserve(count);
+
+    std::uint64_t tick{ 0 };
+    for(std::uint64_t k = 0; k < count; ++k) {
+        std::uint64_t value{ 0 };
+        if(!get_varint(cursor, end, value)) {
+            return 0;
+        }
+
+        tick += value >> 2;
+        t_replay.changes.push_back({ tick, static_cast<direction_type>(value & 3) });
+    }
+
+    if(!get_varint(cursor, end, t_replay.tick_count)) {
+        return 0;
+    }
+
+    return static_cast<std::size_t>(cursor - t_data);
+}
+
+bool replay_t::save(char const* t_path) const
+{
+    std::vector<std::uint8_t> bytes;
+    this->encode(bytes);
+
+    std::FILE* file = std::fopen(t_path, "wb");
+    if(file == nullptr) {
+        return false;
+    }
+
+    bool const written =
+        std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+
+    return std::fclose(file) == 0 && written;
+}
+
+bool replay_t::load(char const* t_path, replay_t& t_replay)
+{
+    mapped_file_t file{};
+
+    return file.open(t_path) &&
+           decode(file.data(), file.size(), t_replay) != 0;
+}
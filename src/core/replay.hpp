@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/position.hpp"
+
+// A whole game as its seed, board size and the ticks on which the
+// direction passed to simulation_t::step changed. Since the seed fixes
+// every fruit, feeding those directions back reproduces the game exactly.
+//
+// On disk, after the 4-byte magic "SNKR" and a version byte, everything
+// is an unsigned LEB128 varint:
+//   seed, width, height, change count,
+//   per change: (tick - previous change's tick) << 2 | direction,
+//   tick count.
+// Ticks count step() calls from 0; the direction before the first change
+// is UP, the one every game starts with.
+struct direction_change_t
+{
+    std::uint64_t tick{ 0 };
+    direction_type direction{ UP };
+};
+
+struct replay_t
+{
+    static std::uint8_t constexpr version{ 1 };
+    // Bounds decode() puts on the board, so a corrupt or hostile file
+    // can't ask for a huge allocation: each side in [2, max_side] and at
+    // most max_cells cells, the 4096x4096 of snake_bench's largest board.
+    static int constexpr max_side{ 0xFFFF };
+    static std::size_t constexpr max_cells{ std::size_t{ 1 } << 24 };
+
+    std::uint64_t seed{ 0 };
+    int width{ 0 };
+    int height{ 0 };
+    // step() calls the game ran for.
+    std::uint64_t tick_count{ 0 };
+    std::vector<direction_change_t> changes;
+
+    // Appends the encoded replay to t_out.
+    void encode(std::vector<std::uint8_t>& t_out) const;
+    // Returns the bytes read, or 0 if t_data does not hold a whole,
+    // well-formed replay. t_replay is unspecified on failure.
+    static std::size_t decode(std::uint8_t const* t_data, std::size_t const t_size,
+                              replay_t& t_replay);
+
+    // Return false if the file can't be written, read or decoded.
+    bool save(char const* t_path) const;
+    static bool load(char const* t_path, replay_t& t_replay);
+};
+
+// Fed the direction of every step() call, in order.
+struct replay_recorder_t
+{
+private:
+    replay_t m_replay{};
+    direction_type m_last{ UP };
+
+public:
+    replay_recorder_t(std::uint64_t const t_seed, int const t_width, int const t_height)
+    {
+        m_replay.seed = t_seed;
+        m_replay.width = t_width;
+        m_replay.height = t_height;
+    }
+
+    void record(direction_type const t_direction)
+    {
+        if(t_direction != m_last) {
+            m_replay.changes.push_back({ m_replay.tick_count, t_direction });
+            m_last = t_direction;
+        }
+        ++m_replay.tick_count;
+    }
+
+    inline replay_t const& get_replay() const
+    { return m_replay; }
+};
+
+// Hands out the recorded direction of each tick in turn.
+struct replay_player_t
+{
+private:
+    replay_t const& m_replay;
+    std::size_t m_next_change{ 0 };
+    std::uint64_t m_tick{ 0 };
+    direction_type m_direction{ UP };
+
+public:
+    explicit replay_player_t(replay_t const& t_replay) noexcept
+        : m_replay{ t_replay }
+    {}
+
+    inline bool done() const noexcept
+    { return m_tick >= m_replay.tick_count; }
+    inline std::uint64_t get_tick() const noexcept
+    { return m_tick; }
+
+    // Direction for the current tick; only call while !done().
+    direction_type next() noexcept
+    {
+        while(m_next_change < m_replay.changes.size() &&
+              m_replay.changes[m_next_change].tick == m_tick) {
+            m_direction = m_replay.changes[m_next_change++].direction;
+        }
+        ++m_tick;
+        return m_direction;
+    }
+};
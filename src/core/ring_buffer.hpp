@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+// Fixed-capacity double-ended queue over a contiguous buffer (a std::array
+// or a std::vector sized up front; it only changes size through
+// reallocate()). Only the
+// operations the snake body needs are provided: push at the front or the
+// back, pop at either end, and indexed access starting from the front.
+template<typename Buffer>
+struct ring_buffer_t
+{
+public:
+    using value_type = typename Buffer::value_type;
+
+private:
+    Buffer m_data;
+
+    std::size_t m_head{ 0 };
+    std::size_t m_size{ 0 };
+
+    constexpr std::size_t wrap(std::size_t const t_index) const noexcept
+    { return t_index >= m_data.size() ? t_index - m_data.size() : t_index; }
+
+public:
+    ring_buffer_t() = default;
+    explicit ring_buffer_t(Buffer t_data) noexcept
+        : m_data{ std::move(t_data) }
+    {}
+    ~ring_buffer_t() noexcept = default;
+
+    constexpr std::size_t capacity() const noexcept
+    { return m_data.size(); }
+    constexpr std::size_t size() const noexcept
+    { return m_size; }
+    constexpr bool empty() const noexcept
+    { return m_size == 0; }
+    constexpr bool full() const noexcept
+    { return m_size == m_data.size(); }
+
+    constexpr value_type const& front() const noexcept
+    { return m_data[m_head]; }
+    constexpr value_type const& back() const noexcept
+    { return m_data[this->wrap(m_head + m_size - 1)]; }
+
+    // t_index is counted from the front, so (*this)[0] == front().
+    constexpr value_type const& operator[](std::size_t const t_index) const noexcept
+    { return m_data[this->wrap(m_head + t_index)]; }
+
+    void push_front(value_type const& t_value) noexcept
+    {
+        m_head = (m_head == 0) ? m_data.size() - 1 : m_head - 1;
+        m_data[m_head] = t_value;
+        ++m_size;
+    }
+    void push_back(value_type const& t_value) noexcept
+    {
+        m_data[this->wrap(m_head + m_size)] = t_value;
+        ++m_size;
+    }
+    void pop_back() noexcept
+    { --m_size; }
+    void pop_front() noexcept
+    {
+        m_head = this->wrap(m_head + 1);
+        --m_size;
+    }
+
+    // Moves the contents, front first, into t_data, which must have room
+    // for them; for bodies that outgrow their buffer.
+    void reallocate(Buffer t_data)
+    {
+        for(std::size_t k = 0; k < m_size; ++k) {
+            t_data[k] = std::move(m_data[this->wrap(m_head + k)]);
+        }
+
+        m_data = std::move(t_data);
+        m_head = 0;
+    }
+
+    void clear() noexcept
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+};
@@ -0,0 +1,5 @@
+#include "core/simulation.hpp"
+
+template struct simulation_t<default_game_field_t>;
+template struct simulation_t<dynamic_game_field_t>;
+template struct simulation_t<packed_game_field_t>;
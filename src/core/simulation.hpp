@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "core/game_field.hpp"
+#include "core/snake.hpp"
+#include "core/fruit.hpp"
+#include "core/position.hpp"
+#include "core/random.hpp"
+#include "core/tick_delta.hpp"
+#include "core/trace.hpp"
+
+// Everything simulation_t::undo needs to take one step() back: the parts
+// of the state the step overwrote, plus where the cells it emptied or
+// filled sat in the free-cell index.
+struct tick_undo_t
+{
+    tick_delta_t delta{};
+    rng_engine_t rng{};
+
+    position_t fruit{};
+    int fruit_slot{ 0 };
+    // Free slot of the cell the head moved into, -1 if it was not EMPTY.
+    int head_slot{ -1 };
+
+    // The step's argument, replayed by redo().
+    direction_type requested{ UP };
+    direction_type direction{ UP };
+    bool running{ false };
+};
+
+// Headless game state: advances one tick per step() call, with no notion
+// of wall-clock time, windows or input devices. Nothing in it refers to
+// anything else, so it copies like a value; on a fixed-size field it is
+// trivially copyable (see game_state_t).
+template<typename Field>
+struct simulation_t
+{
+public:
+    using field_type = Field;
+
+private:
+    rng_engine_t m_rng;
+    Field m_field;
+    snake_t<Field> m_snake{ m_field };
+    fruit_t<Field> m_fruit{ m_field, m_rng };
+
+    direction_type m_direction{ UP };
+    bool m_running{ true };
+
+    tick_delta_t m_delta{};
+
+    void turn(direction_type const t_direction);
+    void handle_movement();
+
+public:
+    // The seed alone determines where every fruit appears.
+    explicit simulation_t(std::uint64_t const t_seed,
+                          Field t_field = Field{})
+        : m_rng{ t_seed }
+        , m_field{ std::move(t_field) }
+    {}
+    ~simulation_t() noexcept = default;
+
+    // Turns towards t_direction (a reversal onto the snake's own neck is
+    // ignored) and advances the game by one tick. Returns is_running().
+    bool step(direction_type const t_direction);
+    // Same, and fills t_undo so undo(t_undo) can take the tick back.
+    bool step(direction_type const t_direction, tick_undo_t& t_undo);
+
+    // Reverts the step that filled t_undo, which must be the latest step
+    // not undone yet. Undoing a sequence goes newest first; nothing is
+    // allocated, so make/unmake in a tree search costs two cell updates
+    // or so per tick.
+    void undo(tick_undo_t const& t_undo) noexcept;
+    // Steps again as t_undo's step did, after undo(t_undo); the tick
+    // comes out identical because the random engine was rewound too.
+    bool redo(tick_undo_t& t_undo)
+    { return this->step(t_undo.requested, t_undo); }
+
+    constexpr bool is_running() const
+    { return m_running; }
+    constexpr direction_type get_direction() const
+    { return m_direction; }
+
+    inline Field const& get_field() const
+    { return m_field; }
+    inline snake_t<Field> const& get_snake() const
+    { return m_snake; }
+    inline fruit_t<Field> const& get_fruit() const
+    { return m_fruit; }
+    inline std::size_t get_length() const
+    { return m_snake.get_length(); }
+    // What the last step() changed on the field.
+    constexpr tick_delta_t const& get_delta() const
+    { return m_delta; }
+};
+
+template<typename Field>
+void simulation_t<Field>::handle_movement()
+{
+    SNAKE_TRACE_ZONE("simulation_t::handle_movement");
+
+    m_delta = tick_delta_t{};
+    m_delta.old_head = m_snake.get_head_position();
+    m_delta.tail = m_snake.get_tail_position();
+    m_delta.result = m_snake.try_move(m_field, m_direction);
+    m_delta.new_head = m_snake.get_head_position();
+
+    switch(m_delta.result) {
+        case snake_base_t::MOVED:
+            m_delta.tail_removed = true;
+            break;
+        case snake_base_t::ATE:
+            m_running = m_fruit.new_position(m_field, m_rng);
+            m_delta.fruit_moved = m_running;
+            m_delta.fruit = m_fruit.get_position();
+            break;
+        case snake_base_t::COLLIDED:
+            m_running = false;
+            break;
+        default: break;
+    }
+}
+
+template<typename Field>
+void simulation_t<Field>::turn(direction_type const t_direction)
+{
+    // A reversal onto the snake's own neck is ignored.
+    if(t_direction != opposite(m_direction)) {
+        m_direction = t_direction;
+    }
+}
+
+template<typename Field>
+bool simulation_t<Field>::step(direction_type const t_direction)
+{
+    if(!m_running) {
+        return false;
+    }
+
+    this->turn(t_direction);
+    this->handle_movement();
+
+    return m_running;
+}
+
+template<typename Field>
+bool simulation_t<Field>::step(direction_type const t_direction,
+                               tick_undo_t& t_undo)
+{
+    t_undo.delta = m_delta;
+    t_undo.rng = m_rng;
+    t_undo.fruit = m_fruit.get_position();
+    t_undo.fruit_slot = m_fruit.get_slot();
+    t_undo.requested = t_direction;
+    t_undo.direction = m_direction;
+    t_undo.running = m_running;
+
+    if(!m_running) {
+        return false;
+    }
+
+    this->turn(t_direction);
+
+    position_t const target =
+        neighbour(m_snake.get_head_position(), m_direction);
+    t_undo.head_slot = is_inside(target, m_field.width(), m_field.height())
+                     ? m_field.free_slot(target.i, target.j) : -1;
+
+    this->handle_movement();
+
+    return m_running;
+}
+
+template<typename Field>
+void simulation_t<Field>::undo(tick_undo_t const& t_undo) noexcept
+{
+    if(!t_undo.running) {
+        return;
+    }
+
+    switch(m_delta.result) {
+        case snake_base_t::ATE:
+            if(m_delta.fruit_moved) {
+                m_fruit.undo_new_position(m_field, t_undo.fruit, t_undo.fruit_slot);
+            }
+            m_snake.undo_move(m_field, snake_base_t::ATE, m_delta.tail, -1);
+            break;
+        case snake_base_t::MOVED:
+            m_snake.undo_move(m_field, snake_base_t::MOVED, m_delta.tail,
+                              t_undo.head_slot);
+            break;
+        default: break;
+    }
+
+    m_rng = t_undo.rng;
+    m_direction = t_undo.direction;
+    m_running = t_undo.running;
+    m_delta = t_undo.delta;
+}
+
+extern template struct simulation_t<default_game_field_t>;
+extern template struct simulation_t<dynamic_game_field_t>;
+extern template struct simulation_t<packed_game_field_t>;
+
+// A whole game as one plain value: the fixed-size field, snake body, fruit
+// and random engine all live inline, so a state copies with memcpy (see
+// state_pool_t for cloning without allocating).
+template<int Width, int Height>
+using game_state_t = simulation_t<game_field_t<Width, Height>>;
+
+static_assert(std::is_trivially_copyable<game_state_t<10, 10>>::value,
+              "game_state_t must stay copyable with memcpy");
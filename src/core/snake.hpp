@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+
+#include "core/game_field.hpp"
+#include "core/position.hpp"
+#include "core/ring_buffer.hpp"
+#include "core/tick_delta.hpp"
+#include "core/trace.hpp"
+
+template<typename Field>
+struct snake_t : snake_base_t
+{
+private:
+    using body_t = ring_buffer_t<
+        typename Field::template buffer_type<position_t>
+    >;
+
+    body_t m_snake_positions;
+
+    // Called right after a new head was pushed: the rest of the body is
+    // already on the field, so only the old and the new head change.
+    void update_field(Field& t_field, position_t const& t_old_head)
+    {
+        SNAKE_TRACE_ZONE("snake_t::update_field");
+
+        position_t const head = m_snake_positions.front();
+
+        t_field.set(t_old_head.i, t_old_head.j,
+                    Field::cell_type::SNAKE_BODY);
+        t_field.set(head.i, head.j, Field::cell_type::SNAKE_HEAD);
+    }
+
+    void pop_back_snake_body(Field& t_field)
+    {
+        position_t pos = m_snake_positions.back();
+        t_field.set(pos.i, pos.j, Field::cell_type::EMPTY);
+        m_snake_positions.pop_back();
+    }
+
+    static inline bool is_space_for_snake(Field const& t_field,
+                                          position_t const& t_pos)
+    { return !t_field.is_snake(t_pos.i, t_pos.j); }
+
+public:
+    // The snake keeps no reference to the field, so copying a game is
+    // copying its field and its snake; every call that touches the board
+    // takes it as an argument.
+    snake_t() = delete;
+    explicit snake_t(Field& t_field)
+        : m_snake_positions{ t_field.template make_buffer<position_t>() }
+    {
+        m_snake_positions.push_back({
+            t_field.height() / 2 - 1,
+            t_field.width() / 2 - 1
+        });
+
+        position_t const head = m_snake_positions.front();
+        t_field.set(head.i, head.j, Field::cell_type::SNAKE_HEAD);
+    }
+    ~snake_t() noexcept = default;
+
+    inline std::size_t get_length() const
+    { return m_snake_positions.size(); }
+    inline position_t get_head_position() const
+    { return m_snake_positions.front(); }
+    inline position_t get_tail_position() const
+    { return m_snake_positions.back(); }
+    // t_index counts from the head, so get_position(0) is the head.
+    inline position_t get_position(std::size_t const t_index) const
+    { return m_snake_positions[t_index]; }
+
+    // The single bounds and occupancy check behind every move, whichever
+    // way the snake goes.
+    bool try_lengthen(Field& t_field, direction_type const t_direction) noexcept
+    {
+        position_t const head_pos = m_snake_positions.front();
+        position_t const target = neighbour(head_pos, t_direction);
+
+        if(!is_inside(target, t_field.width(), t_field.height()) ||
+           !is_space_for_snake(t_field, target)) {
+            return false;
+        }
+
+        m_snake_positions.push_front(target);
+        this->update_field(t_field, head_pos);
+        return true;
+    }
+    void lengthen(Field& t_field, direction_type const t_direction)
+    {
+        if(!this->try_lengthen(t_field, t_direction)) {
+            throw "Can't move snake";
+        }
+    }
+    void move(Field& t_field, direction_type const t_direction)
+    {
+        this->lengthen(t_field, t_direction);
+        this->pop_back_snake_body(t_field);
+    }
+
+    // Non-throwing move used by the simulation: grows the snake when the
+    // target cell holds a fruit, otherwise moves it along. The target is
+    // read once, for both the collision and the fruit.
+    move_result try_move(Field& t_field, direction_type const t_direction) noexcept
+    {
+        position_t const head_pos = m_snake_positions.front();
+        position_t const target = neighbour(head_pos, t_direction);
+
+        if(!is_inside(target, t_field.width(), t_field.height())) {
+            return COLLIDED;
+        }
+
+        auto const cell = t_field(target.i, target.j);
+        if((cell & field_base_t::SNAKE_MASK) != 0) {
+            return COLLIDED;
+        }
+
+        m_snake_positions.push_front(target);
+        this->update_field(t_field, head_pos);
+
+        if(cell == Field::cell_type::FRUIT) {
+            return ATE;
+        }
+
+        this->pop_back_snake_body(t_field);
+        return MOVED;
+    }
+
+    // Reverts the latest try_move(), which returned t_result (MOVED or
+    // ATE) and, for a fruit, has not been followed by a new fruit yet.
+    // t_tail is the tail from before that move and t_head_slot the free
+    // slot of the cell the head moved into.
+    void undo_move(Field& t_field, move_result const t_result,
+                   position_t const& t_tail, int const t_head_slot) noexcept
+    {
+        position_t const head = m_snake_positions.front();
+
+        if(t_result == MOVED) {
+            t_field.revert(t_tail.i, t_tail.j, Field::cell_type::SNAKE_BODY, -1);
+            m_snake_positions.push_back(t_tail);
+            t_field.revert(head.i, head.j, Field::cell_type::EMPTY, t_head_slot);
+        }
+        else {
+            t_field.set(head.i, head.j, Field::cell_type::FRUIT);
+        }
+
+        m_snake_positions.pop_front();
+
+        position_t const old_head = m_snake_positions.front();
+        t_field.set(old_head.i, old_head.j, Field::cell_type::SNAKE_HEAD);
+    }
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Capacity must be a power of two; push() fails instead of
+// overwriting when the queue is full.
+template<typename T, std::size_t Capacity>
+struct spsc_queue_t
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "capacity must be a power of two");
+
+private:
+    std::array<T, Capacity> m_items{};
+
+    alignas(64) std::atomic<std::size_t> m_head{ 0 };
+    alignas(64) std::atomic<std::size_t> m_tail{ 0 };
+
+public:
+    spsc_queue_t() noexcept = default;
+    spsc_queue_t(spsc_queue_t const&) = delete;
+    spsc_queue_t& operator=(spsc_queue_t const&) = delete;
+    ~spsc_queue_t() noexcept = default;
+
+    static constexpr std::size_t capacity() noexcept
+    { return Capacity; }
+
+    bool push(T const& t_item) noexcept
+    {
+        std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        m_items[tail & (Capacity - 1)] = t_item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& t_item) noexcept
+    {
+        std::size_t const head = m_head.load(std::memory_order_relaxed);
+        if(head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        t_item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire) ==
+               m_tail.load(std::memory_order_acquire);
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Fixed number of slots for copies of a trivially copyable State (such as
+// game_state_t), allocated once up front. clone() copies a state into a
+// free slot, release() gives one slot back and clear() frees every slot
+// at once, arena style. None of them allocates.
+template<typename State>
+struct state_pool_t
+{
+    static_assert(std::is_trivially_copyable<State>::value,
+                  "state_pool_t copies states bytewise");
+
+private:
+    struct alignas(State) slot_t
+    {
+        unsigned char bytes[sizeof(State)];
+    };
+
+    std::unique_ptr<slot_t[]> m_slots;
+    std::size_t m_capacity{ 0 };
+
+    std::vector<std::uint32_t> m_free;
+
+public:
+    explicit state_pool_t(std::size_t const t_capacity)
+        : m_slots{ std::make_unique<slot_t[]>(t_capacity) }
+        , m_capacity{ t_capacity }
+    {
+        m_free.reserve(t_capacity);
+        this->clear();
+    }
+    state_pool_t(state_pool_t const&) = delete;
+    state_pool_t& operator=(state_pool_t const&) = delete;
+    ~state_pool_t() noexcept = default;
+
+    // nullptr once every slot is taken.
+    State* clone(State const& t_state) noexcept
+    {
+        if(m_free.empty()) {
+            return nullptr;
+        }
+
+        slot_t& slot = m_slots[m_free.back()];
+        m_free.pop_back();
+
+        return ::new(static_cast<void*>(slot.bytes)) State(t_state);
+    }
+
+    // t_state must come from clone() on this pool and not be released yet.
+    void release(State* const t_state) noexcept
+    {
+        auto const* slot = reinterpret_cast<slot_t const*>(t_state);
+        m_free.push_back(static_cast<std::uint32_t>(slot - m_slots.get()));
+    }
+
+    // Releases every state; pointers handed out before become invalid.
+    void clear() noexcept
+    {
+        m_free.clear();
+        for(std::size_t k = m_capacity; k > 0; --k) {
+            m_free.push_back(static_cast<std::uint32_t>(k - 1));
+        }
+    }
+
+    inline std::size_t capacity() const noexcept
+    { return m_capacity; }
+    inline std::size_t size() const noexcept
+    { return m_capacity - m_free.size(); }
+};
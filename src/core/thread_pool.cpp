@@ -0,0 +1,140 @@
+#include "core/thread_pool.hpp"
+
+#include <algorithm>
+
+#include "core/trace.hpp"
+
+thread_pool_t::thread_pool_t(std::size_t t_threads)
+{
+    if(t_threads == 0) {
+        t_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_worker_count = t_threads;
+    m_queues = std::make_unique<chunk_queue_t[]>(m_worker_count);
+
+    m_threads.reserve(m_worker_count - 1);
+    for(std::size_t worker = 1; worker < m_worker_count; ++worker) {
+        m_threads.emplace_back(&thread_pool_t::worker_loop, this, worker);
+    }
+}
+
+thread_pool_t::~thread_pool_t() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for(auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+bool thread_pool_t::take(std::size_t const t_worker, std::size_t& t_chunk)
+{
+    chunk_queue_t& queue = m_queues[t_worker];
+    std::lock_guard<std::mutex> lock{ queue.mutex };
+
+    if(queue.next == queue.last) {
+        return false;
+    }
+
+    t_chunk = queue.next++;
+    return true;
+}
+
+bool thread_pool_t::steal(std::size_t const t_worker, std::size_t& t_chunk)
+{
+    for(std::size_t offset = 1; offset < m_worker_count; ++offset) {
+        chunk_queue_t& queue = m_queues[(t_worker + offset) % m_worker_count];
+        std::lock_guard<std::mutex> lock{ queue.mutex };
+
+        if(queue.next != queue.last) {
+            t_chunk = --queue.last;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void thread_pool_t::work(std::size_t const t_worker)
+{
+    std::size_t chunk{ 0 };
+
+    while(this->take(t_worker, chunk) || this->steal(t_worker, chunk)) {
+        std::size_t const begin = m_job.begin + chunk * m_job.grain;
+        std::size_t const end = std::min(m_job.end, begin + m_job.grain);
+
+        {
+            SNAKE_TRACE_ZONE("thread_pool_t::chunk");
+            m_job.function(m_job.context, begin, end);
+        }
+
+        if(m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_done.notify_all();
+        }
+    }
+}
+
+void thread_pool_t::worker_loop(std::size_t const t_worker)
+{
+    std::uint64_t seen{ 0 };
+
+    while(true) {
+        {
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            m_wake.wait(lock, [this, seen]() {
+                return m_stop || m_generation != seen;
+            });
+
+            if(m_stop) {
+                return;
+            }
+
+            seen = m_generation;
+            ++m_active;
+        }
+
+        this->work(t_worker);
+
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            --m_active;
+        }
+        m_done.notify_all();
+    }
+}
+
+void thread_pool_t::dispatch(job_t const& t_job)
+{
+    std::size_t const chunks = (t_job.end - t_job.begin + t_job.grain - 1) / t_job.grain;
+
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        m_job = t_job;
+        m_remaining.store(chunks, std::memory_order_relaxed);
+
+        for(std::size_t worker = 0; worker < m_worker_count; ++worker) {
+            chunk_queue_t& queue = m_queues[worker];
+            std::lock_guard<std::mutex> queue_lock{ queue.mutex };
+
+            queue.next = chunks * worker / m_worker_count;
+            queue.last = chunks * (worker + 1) / m_worker_count;
+        }
+
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    this->work(0);
+
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_done.wait(lock, [this]() {
+        return m_remaining.load(std::memory_order_acquire) == 0 && m_active == 0;
+    });
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads running parallel_for() jobs. A job's range is
+// cut into chunks of `grain` items and dealt out evenly to one queue per
+// worker; a worker takes chunks from the front of its own queue and, once
+// that is empty, steals from the back of the others'. The calling thread
+// works as worker 0 and parallel_for() returns when every chunk is done.
+// Nothing is allocated per job. Tasks must not throw.
+struct thread_pool_t
+{
+private:
+    using task_fn = void (*)(void*, std::size_t, std::size_t);
+
+    struct job_t
+    {
+        task_fn function{ nullptr };
+        void* context{ nullptr };
+        std::size_t begin{ 0 };
+        std::size_t end{ 0 };
+        std::size_t grain{ 1 };
+    };
+
+    // Chunk ids [next, last) still owned by one worker.
+    struct alignas(64) chunk_queue_t
+    {
+        std::mutex mutex;
+        std::size_t next{ 0 };
+        std::size_t last{ 0 };
+    };
+
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<chunk_queue_t[]> m_queues;
+    std::size_t m_worker_count{ 1 };
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    job_t m_job{};
+    std::uint64_t m_generation{ 0 };
+    std::size_t m_active{ 0 };
+    bool m_stop{ false };
+    std::atomic<std::size_t> m_remaining{ 0 };
+
+    bool take(std::size_t const t_worker, std::size_t& t_chunk);
+    bool steal(std::size_t const t_worker, std::size_t& t_chunk);
+    void work(std::size_t const t_worker);
+    void worker_loop(std::size_t const t_worker);
+    void dispatch(job_t const& t_job);
+
+public:
+    // t_threads counts the calling thread; 0 means one per hardware thread.
+    explicit thread_pool_t(std::size_t t_threads = 0);
+    thread_pool_t(thread_pool_t const&) = delete;
+    thread_pool_t& operator=(thread_pool_t const&) = delete;
+    ~thread_pool_t() noexcept;
+
+    inline std::size_t size() const
+    { return m_worker_count; }
+
+    // Calls t_function(chunk_begin, chunk_end) over [t_begin, t_end).
+    template<typename Function>
+    void parallel_for(std::size_t const t_begin, std::size_t const t_end,
+                      std::size_t const t_grain, Function&& t_function)
+    {
+        if(t_begin >= t_end) {
+            return;
+        }
+
+        job_t job{};
+        job.function = [](void* t_context, std::size_t t_chunk_begin,
+                          std::size_t t_chunk_end) {
+            (*static_cast<std::remove_reference_t<Function>*>(t_context))(
+                t_chunk_begin, t_chunk_end
+            );
+        };
+        job.context = static_cast<void*>(&t_function);
+        job.begin = t_begin;
+        job.end = t_end;
+        job.grain = t_grain > 0 ? t_grain : 1;
+
+        this->dispatch(job);
+    }
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/position.hpp"
+
+struct snake_base_t
+{
+    enum move_result
+    {
+        MOVED = 0,
+        ATE,
+        COLLIDED
+    };
+};
+
+// The cells one tick changed: the old head turned into body, the new head
+// appeared, and either the tail was cleared or a new fruit was placed. A
+// collision changes nothing.
+struct tick_delta_t
+{
+    snake_base_t::move_result result{ snake_base_t::MOVED };
+
+    position_t old_head{};
+    position_t new_head{};
+
+    bool tail_removed{ false };
+    position_t tail{};
+
+    bool fruit_moved{ false };
+    position_t fruit{};
+
+    template<typename Function>
+    void for_each_cell(Function&& t_function) const
+    {
+        if(result == snake_base_t::COLLIDED) {
+            return;
+        }
+
+        t_function(old_head);
+        t_function(new_head);
+
+        if(tail_removed) {
+            t_function(tail);
+        }
+        if(fruit_moved) {
+            t_function(fruit);
+        }
+    }
+};
@@ -0,0 +1,165 @@
+#include "core/trace.hpp"
+
+#if defined(SNAKE_TRACE_CHROME)
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+    struct trace_event_t
+    {
+        char const* name;
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    std::size_t constexpr chunk_size{ 4096 };
+    std::size_t constexpr max_chunks{ 1024 };
+
+    // Events are appended by the owning thread only. A chunk is published
+    // before the count that first reaches into it, and the exporter only
+    // reads below the count it loads, so neither side ever locks.
+    struct thread_buffer_t
+    {
+        std::uint32_t thread{ 0 };
+        std::array<std::atomic<trace_event_t*>, max_chunks> chunks{};
+        std::atomic<std::size_t> count{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+
+        ~thread_buffer_t() noexcept
+        {
+            for(auto& chunk : chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Buffers outlive their threads, so zones of finished workers are
+    // still written out.
+    std::mutex g_mutex;
+    std::vector<std::unique_ptr<thread_buffer_t>> g_buffers;
+
+    thread_local bool g_allocating{ false };
+
+    // Marks the calling thread as allocating for the tracer while alive.
+    struct allocation_scope_t
+    {
+        allocation_scope_t() noexcept
+        { g_allocating = true; }
+        allocation_scope_t(allocation_scope_t const&) = delete;
+        allocation_scope_t& operator=(allocation_scope_t const&) = delete;
+        ~allocation_scope_t() noexcept
+        { g_allocating = false; }
+    };
+
+    thread_buffer_t* register_thread()
+    {
+        allocation_scope_t const scope{};
+        std::lock_guard<std::mutex> lock{ g_mutex };
+
+        g_buffers.push_back(std::make_unique<thread_buffer_t>());
+        g_buffers.back()->thread = static_cast<std::uint32_t>(g_buffers.size());
+        return g_buffers.back().get();
+    }
+}
+
+void trace_record(char const* t_name, std::uint64_t const t_start_ns,
+                  std::uint64_t const t_end_ns) noexcept
+{
+    thread_local thread_buffer_t* const buffer = register_thread();
+
+    std::size_t const count = buffer->count.load(std::memory_order_relaxed);
+    std::size_t const chunk = count / chunk_size;
+
+    if(chunk >= max_chunks) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    trace_event_t* events = buffer->chunks[chunk].load(std::memory_order_relaxed);
+    if(events == nullptr) {
+        {
+            allocation_scope_t const scope{};
+            events = new(std::nothrow) trace_event_t[chunk_size];
+        }
+        if(events == nullptr) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer->chunks[chunk].store(events, std::memory_order_release);
+    }
+
+    events[count % chunk_size] = trace_event_t{ t_name, t_start_ns, t_end_ns };
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+bool trace_write_chrome(char const* t_path)
+{
+    std::FILE* file = std::fopen(t_path, "w");
+    if(file == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock{ g_mutex };
+
+    // Timestamps are microseconds from the earliest zone.
+    std::uint64_t origin{ UINT64_MAX };
+    for(auto const& buffer : g_buffers) {
+        std::size_t const count = buffer->count.load(std::memory_order_acquire);
+
+        for(std::size_t k = 0; k < count; ++k) {
+            origin = std::min(origin, buffer->chunks[k / chunk_size].load(
+                std::memory_order_acquire)[k % chunk_size].start);
+        }
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first{ true };
+
+    for(auto const& buffer : g_buffers) {
+        std::size_t const count = buffer->count.load(std::memory_order_acquire);
+
+        for(std::size_t k = 0; k < count; ++k) {
+            trace_event_t const& event =
+                buffer->chunks[k / chunk_size].load(std::memory_order_acquire)[k % chunk_size];
+
+            std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                               "\"ts\":%.3f,\"dur\":%.3f}",
+                         first ? "" : ",\n", event.name, static_cast<unsigned>(buffer->thread),
+                         (event.start - origin) / 1000.0, (event.end - event.start) / 1000.0);
+            first = false;
+        }
+
+        std::uint64_t const dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if(dropped > 0) {
+            std::fprintf(file, "%s{\"name\":\"dropped %llu zones\",\"ph\":\"i\",\"s\":\"t\","
+                               "\"pid\":1,\"tid\":%u,\"ts\":0}",
+                         first ? "" : ",\n", static_cast<unsigned long long>(dropped),
+                         static_cast<unsigned>(buffer->thread));
+            first = false;
+        }
+    }
+
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+bool trace_allocating() noexcept
+{ return g_allocating; }
+
+#else
+
+bool trace_write_chrome(char const*)
+{ return false; }
+
+bool trace_allocating() noexcept
+{ return false; }
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+// Scoped trace zones, chosen at configure time with -DSNAKE_TRACE:
+//   OFF     SNAKE_TRACE_ZONE expands to nothing
+//   CHROME  every zone is kept in a buffer of the thread it ran on and
+//           trace_write_chrome() writes them all as Chrome trace JSON,
+//           for chrome://tracing or Perfetto
+//   TRACY   zones go to Tracy as ZoneScopedN
+// t_name must be a string literal that needs no JSON escaping.
+#if defined(SNAKE_TRACE_TRACY)
+
+#include <tracy/Tracy.hpp>
+
+#define SNAKE_TRACE_ZONE(t_name) ZoneScopedN(t_name)
+
+#elif defined(SNAKE_TRACE_CHROME)
+
+#include <chrono>
+#include <cstdint>
+
+// Records [start, end) in the calling thread's buffer; only that thread
+// ever writes to it, so this takes no lock. A thread keeps at most a few
+// million zones and drops the rest.
+void trace_record(char const* t_name, std::uint64_t const t_start_ns,
+                  std::uint64_t const t_end_ns) noexcept;
+
+inline std::uint64_t trace_now_ns() noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+struct trace_zone_t
+{
+private:
+    char const* m_name;
+    std::uint64_t m_start;
+
+public:
+    explicit trace_zone_t(char const* t_name) noexcept
+        : m_name{ t_name }
+        , m_start{ trace_now_ns() }
+    {}
+    trace_zone_t(trace_zone_t const&) = delete;
+    trace_zone_t& operator=(trace_zone_t const&) = delete;
+    ~trace_zone_t() noexcept
+    { trace_record(m_name, m_start, trace_now_ns()); }
+};
+
+#define SNAKE_TRACE_JOIN_(t_a, t_b) t_a##t_b
+#define SNAKE_TRACE_JOIN(t_a, t_b) SNAKE_TRACE_JOIN_(t_a, t_b)
+#define SNAKE_TRACE_ZONE(t_name) \
+    trace_zone_t const SNAKE_TRACE_JOIN(snake_trace_zone_, __LINE__){ t_name }
+
+#else
+
+#define SNAKE_TRACE_ZONE(t_name) static_cast<void>(0)
+
+#endif
+
+// Writes every zone recorded so far, from all threads, to t_path. Returns
+// false if the file can't be written or the build has no CHROME zones.
+bool trace_write_chrome(char const* t_path);
+
+// True while the calling thread is allocating its own trace buffers, so
+// an allocation counter can leave the tracer's overhead out. Always false
+// without CHROME zones.
+bool trace_allocating() noexcept;
@@ -0,0 +1,261 @@
+#include "core/trajectory.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace {
+    std::uint64_t constexpr align8(std::uint64_t const t_size) noexcept
+    { return (t_size + 7) & ~std::uint64_t{ 7 }; }
+
+    // Whether a board side fits the header's 16-bit field.
+    bool constexpr fits_side(int const t_side) noexcept
+    { return t_side > 0 && t_side <= std::numeric_limits<std::uint16_t>::max(); }
+
+    std::uint64_t constexpr record_size(std::uint64_t const t_ticks,
+                                        std::uint64_t const t_cells) noexcept
+    {
+        return sizeof(trajectory_episode_header_t)
+             + align8(2 * t_ticks)
+             + align8(t_ticks * t_cells);
+    }
+}
+
+trajectory_writer_t::~trajectory_writer_t() noexcept
+{
+    if(m_file != nullptr) {
+        this->finish();
+    }
+}
+
+bool trajectory_writer_t::write(void const* t_data, std::size_t const t_size)
+{
+    if(m_ok && t_size > 0) {
+        m_ok = std::fwrite(t_data, 1, t_size, m_file) == t_size;
+        m_offset += t_size;
+    }
+    return m_ok;
+}
+
+bool trajectory_writer_t::pad()
+{
+    std::uint8_t constexpr zeros[8]{};
+    return this->write(zeros, align8(m_offset) - m_offset);
+}
+
+bool trajectory_writer_t::open(char const* t_path,
+                               std::uint32_t const t_episodes_per_chunk)
+{
+    if(m_file != nullptr) {
+        this->finish();
+    }
+
+    m_file = std::fopen(t_path, "wb");
+    m_ok = m_file != nullptr;
+    m_offset = 0;
+    m_episodes_per_chunk = t_episodes_per_chunk > 0 ? t_episodes_per_chunk : 1;
+    m_index.clear();
+    m_episode_count = 0;
+
+    trajectory_file_header_t header{};
+    header.episodes_per_chunk = m_episodes_per_chunk;
+
+    return this->write(&header, sizeof(header));
+}
+
+bool trajectory_writer_t::begin_episode(std::uint64_t const t_seed,
+                                        int const t_width, int const t_height)
+{
+    m_header = trajectory_episode_header_t{};
+    m_episode_fits = fits_side(t_width) && fits_side(t_height);
+
+    m_actions.clear();
+    m_results.clear();
+    m_states.clear();
+
+    if(!m_episode_fits) {
+        return false;
+    }
+
+    m_header.seed = t_seed;
+    m_header.width = static_cast<std::uint16_t>(t_width);
+    m_header.height = static_cast<std::uint16_t>(t_height);
+    return m_ok;
+}
+
+void trajectory_writer_t::add_tick(field_base_t::cell_type const* t_state,
+                                   direction_type const t_action,
+                                   snake_base_t::move_result const t_result)
+{
+    if(!m_episode_fits) {
+        return;
+    }
+
+    std::size_t const cells = std::size_t{ m_header.width } * m_header.height;
+
+    m_actions.push_back(static_cast<std::uint8_t>(t_action));
+    m_results.push_back(static_cast<std::uint8_t>(t_result));
+    m_states.insert(m_states.end(), t_state, t_state + cells);
+    ++m_header.tick_count;
+}
+
+bool trajectory_writer_t::end_episode()
+{
+    return m_episode_fits && this->write_episode(
+        m_header.seed, m_header.width, m_header.height, m_header.tick_count,
+        m_actions.data(), m_results.data(), m_states.data()
+    );
+}
+
+bool trajectory_writer_t::write_episode(std::uint64_t const t_seed,
+                                        int const t_width, int const t_height,
+                                        std::size_t const t_ticks,
+                                        std::uint8_t const* t_actions,
+                                        std::uint8_t const* t_results,
+                                        field_base_t::cell_type const* t_states)
+{
+    if(!fits_side(t_width) || !fits_side(t_height) ||
+       t_ticks > std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+
+    if(m_episode_count % m_episodes_per_chunk == 0) {
+        m_index.push_back(m_offset);
+    }
+    ++m_episode_count;
+
+    trajectory_episode_header_t header{};
+    header.seed = t_seed;
+    header.tick_count = static_cast<std::uint32_t>(t_ticks);
+    header.width = static_cast<std::uint16_t>(t_width);
+    header.height = static_cast<std::uint16_t>(t_height);
+
+    std::uint64_t const cells = std::uint64_t{ header.width } * header.height;
+    header.size = record_size(header.tick_count, cells);
+
+    return this->write(&header, sizeof(header)) &&
+           this->write(t_actions, t_ticks) &&
+           this->write(t_results, t_ticks) &&
+           this->pad() &&
+           this->write(t_states, t_ticks * cells) &&
+           this->pad();
+}
+
+bool trajectory_writer_t::finish()
+{
+    if(m_file == nullptr) {
+        return false;
+    }
+
+    trajectory_footer_t footer{};
+    footer.index_offset = m_offset;
+    footer.chunk_count = m_index.size();
+    footer.episode_count = m_episode_count;
+
+    this->write(m_index.data(), m_index.size() * sizeof(std::uint64_t));
+    this->write(&footer, sizeof(footer));
+
+    bool const closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+
+    return closed && m_ok;
+}
+
+bool trajectory_reader_t::open(char const* t_path)
+{
+    m_index = nullptr;
+    m_footer = trajectory_footer_t{};
+
+    if(!m_file.open(t_path) ||
+       m_file.size() < sizeof(m_header) + sizeof(m_footer)) {
+        return false;
+    }
+
+    trajectory_file_header_t const expected{};
+    trajectory_footer_t footer{};
+
+    std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+    std::memcpy(&footer, m_file.data() + m_file.size() - sizeof(footer), sizeof(footer));
+
+    std::uint64_t const index_end = m_file.size() - sizeof(footer);
+
+    if(std::memcmp(m_header.magic, expected.magic, sizeof(expected.magic)) != 0 ||
+       m_header.version != expected.version || m_header.episodes_per_chunk == 0 ||
+       std::memcmp(footer.magic, expected.magic, sizeof(expected.magic)) != 0 ||
+       footer.version != expected.version ||
+       footer.index_offset > index_end || footer.index_offset % 8 != 0 ||
+       footer.chunk_count != (index_end - footer.index_offset) / sizeof(std::uint64_t) ||
+       footer.chunk_count !=
+           (footer.episode_count + m_header.episodes_per_chunk - 1) / m_header.episodes_per_chunk) {
+        return false;
+    }
+
+    m_footer = footer;
+    m_index = reinterpret_cast<std::uint64_t const*>(m_file.data() + footer.index_offset);
+    return true;
+}
+
+std::uint64_t trajectory_reader_t::view_at(std::uint64_t const t_offset,
+                                           episode_view_t& t_view) const noexcept
+{
+    std::uint64_t const end = m_footer.index_offset;
+
+    if(t_offset % 8 != 0 || t_offset < sizeof(m_header) ||
+       t_offset + sizeof(trajectory_episode_header_t) > end) {
+        return 0;
+    }
+
+    auto const* header = reinterpret_cast<trajectory_episode_header_t const*>(
+        m_file.data() + t_offset
+    );
+    std::uint64_t const cells = std::uint64_t{ header->width } * header->height;
+
+    if(header->size != record_size(header->tick_count, cells) ||
+       header->size > end - t_offset) {
+        return 0;
+    }
+
+    std::uint8_t const* const body = m_file.data() + t_offset + sizeof(*header);
+
+    t_view.header = header;
+    t_view.actions = body;
+    t_view.results = body + header->tick_count;
+    t_view.states = reinterpret_cast<field_base_t::cell_type const*>(
+        body + align8(2 * std::uint64_t{ header->tick_count })
+    );
+
+    return t_offset + header->size;
+}
+
+std::uint64_t trajectory_reader_t::offset_of(std::size_t const t_episode) const noexcept
+{
+    if(t_episode >= this->episode_count()) {
+        return 0;
+    }
+
+    std::uint64_t offset = m_index[t_episode / m_header.episodes_per_chunk];
+    episode_view_t view{};
+
+    for(std::size_t skip = t_episode % m_header.episodes_per_chunk;
+        skip > 0 && offset != 0; --skip) {
+        offset = this->view_at(offset, view);
+    }
+
+    return offset;
+}
+
+bool trajectory_reader_t::episode(std::size_t const t_episode,
+                                  episode_view_t& t_view) const noexcept
+{
+    std::uint64_t const offset = this->offset_of(t_episode);
+    return offset != 0 && this->view_at(offset, t_view) != 0;
+}
+
+trajectory_reader_t::cursor_t trajectory_reader_t::cursor(std::size_t const t_first) const noexcept
+{
+    cursor_t cursor{};
+    cursor.reader = this;
+    cursor.offset = this->offset_of(t_first);
+    cursor.remaining = t_first < this->episode_count()
+        ? this->episode_count() - t_first : 0;
+    return cursor;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "core/game_field.hpp"
+#include "core/mapped_file.hpp"
+#include "core/position.hpp"
+#include "core/tick_delta.hpp"
+
+// Datasets of whole episodes — the state before every tick, the action
+// taken and its outcome — meant to be written by the batch engine and read
+// back through mmap without copying or parsing what comes before.
+//
+// File layout, little-endian, every section 8-byte aligned:
+//   file header        "SNKT", version, episodes per chunk
+//   episodes           back to back, see trajectory_episode_header_t
+//   chunk index        offset of the first episode of every chunk
+//   footer             where the index is and how many episodes there are
+// Seeking to episode n reads one index entry and skips at most
+// episodes-per-chunk - 1 headers.
+struct trajectory_file_header_t
+{
+    char magic[4]{ 'S', 'N', 'K', 'T' };
+    std::uint32_t version{ 1 };
+    std::uint32_t episodes_per_chunk{ 64 };
+    std::uint32_t reserved{ 0 };
+};
+
+// Followed by tick_count actions (direction_type, one byte each),
+// tick_count results (snake_base_t::move_result, one byte each), padding
+// to 8 bytes, then tick_count row-major cell planes of width * height
+// bytes, the first being the board the episode starts from.
+struct trajectory_episode_header_t
+{
+    std::uint64_t seed{ 0 };
+    // Of the whole record, header and padding included.
+    std::uint64_t size{ 0 };
+    std::uint32_t tick_count{ 0 };
+    std::uint16_t width{ 0 };
+    std::uint16_t height{ 0 };
+};
+
+struct trajectory_footer_t
+{
+    std::uint64_t index_offset{ 0 };
+    std::uint64_t chunk_count{ 0 };
+    std::uint64_t episode_count{ 0 };
+    char magic[4]{ 'S', 'N', 'K', 'T' };
+    std::uint32_t version{ 1 };
+};
+
+// Points straight into the mapping; valid while the reader is open.
+struct episode_view_t
+{
+    trajectory_episode_header_t const* header{ nullptr };
+    std::uint8_t const* actions{ nullptr };
+    std::uint8_t const* results{ nullptr };
+    field_base_t::cell_type const* states{ nullptr };
+
+    inline std::size_t size() const noexcept
+    { return header->tick_count; }
+    inline std::size_t cells() const noexcept
+    { return std::size_t{ header->width } * header->height; }
+
+    inline direction_type action(std::size_t const t_tick) const noexcept
+    { return static_cast<direction_type>(actions[t_tick]); }
+    inline snake_base_t::move_result result(std::size_t const t_tick) const noexcept
+    { return static_cast<snake_base_t::move_result>(results[t_tick]); }
+    // +1 for a fruit, -1 for the collision that ends an episode, else 0.
+    inline int reward(std::size_t const t_tick) const noexcept
+    {
+        switch(this->result(t_tick)) {
+            case snake_base_t::ATE: return 1;
+            case snake_base_t::COLLIDED: return -1;
+            default: return 0;
+        }
+    }
+    // The board t_tick's action was taken on.
+    inline field_base_t::cell_type const* state(std::size_t const t_tick) const noexcept
+    { return states + t_tick * this->cells(); }
+};
+
+// Buffers one episode at a time and writes it out whole. Every function
+// returns false once a write has failed, and for an episode whose board
+// sides or tick count don't fit the header (nothing is written then).
+struct trajectory_writer_t
+{
+private:
+    std::FILE* m_file{ nullptr };
+    bool m_ok{ false };
+    std::uint64_t m_offset{ 0 };
+    std::uint32_t m_episodes_per_chunk{ 64 };
+
+    std::vector<std::uint64_t> m_index;
+    std::uint64_t m_episode_count{ 0 };
+
+    trajectory_episode_header_t m_header{};
+    bool m_episode_fits{ false };
+    std::vector<std::uint8_t> m_actions;
+    std::vector<std::uint8_t> m_results;
+    std::vector<field_base_t::cell_type> m_states;
+
+    bool write(void const* t_data, std::size_t const t_size);
+    bool pad();
+
+public:
+    trajectory_writer_t() noexcept = default;
+    trajectory_writer_t(trajectory_writer_t const&) = delete;
+    trajectory_writer_t& operator=(trajectory_writer_t const&) = delete;
+    // Finishes the file if finish() was not called.
+    ~trajectory_writer_t() noexcept;
+
+    // Finishes the file already open, if any, before starting t_path.
+    bool open(char const* t_path, std::uint32_t const t_episodes_per_chunk = 64);
+
+    // Returns false if t_width or t_height is outside [1, 65535]; the
+    // episode's ticks are then dropped and end_episode() fails.
+    bool begin_episode(std::uint64_t const t_seed, int const t_width, int const t_height);
+    // t_state is the width * height board t_action was taken on.
+    void add_tick(field_base_t::cell_type const* t_state,
+                  direction_type const t_action,
+                  snake_base_t::move_result const t_result);
+    bool end_episode();
+
+    // Writes a whole episode kept elsewhere, e.g. one per game of a batch.
+    // Each array holds t_ticks entries, t_states t_ticks boards.
+    bool write_episode(std::uint64_t const t_seed, int const t_width, int const t_height,
+                       std::size_t const t_ticks,
+                       std::uint8_t const* t_actions, std::uint8_t const* t_results,
+                       field_base_t::cell_type const* t_states);
+
+    // Writes the chunk index and footer and closes the file.
+    bool finish();
+};
+
+struct trajectory_reader_t
+{
+private:
+    mapped_file_t m_file{};
+    trajectory_file_header_t m_header{};
+    trajectory_footer_t m_footer{};
+    std::uint64_t const* m_index{ nullptr };
+
+    // 0 if t_episode is out of range or a record on the way is malformed.
+    std::uint64_t offset_of(std::size_t const t_episode) const noexcept;
+
+public:
+    // Returns false if t_path is missing, truncated or not a trajectory
+    // file. Only the header, footer and index are looked at.
+    bool open(char const* t_path);
+
+    inline std::size_t episode_count() const noexcept
+    { return static_cast<std::size_t>(m_footer.episode_count); }
+
+    // t_offset must be the offset of an episode; fills t_view and returns
+    // the offset of the next one, or 0 if the record is malformed.
+    std::uint64_t view_at(std::uint64_t const t_offset, episode_view_t& t_view) const noexcept;
+    // Returns false if t_episode is out of range or malformed.
+    bool episode(std::size_t const t_episode, episode_view_t& t_view) const noexcept;
+
+    // Walks the episodes from t_first on, one record per next() call.
+    struct cursor_t
+    {
+        trajectory_reader_t const* reader{ nullptr };
+        std::uint64_t offset{ 0 };
+        std::size_t remaining{ 0 };
+
+        bool next(episode_view_t& t_view) noexcept
+        {
+            if(remaining == 0 || offset == 0) {
+                return false;
+            }
+
+            offset = reader->view_at(offset, t_view);
+            --remaining;
+            return offset != 0;
+        }
+    };
+
+    cursor_t cursor(std::size_t const t_first = 0) const noexcept;
+};
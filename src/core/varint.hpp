@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Unsigned LEB128: seven bits per byte, least significant group first,
+// the top bit set on every byte but the last.
+
+inline void put_varint(std::vector<std::uint8_t>& t_out, std::uint64_t t_value)
+{
+    while(t_value >= 0x80) {
+        t_out.push_back(static_cast<std::uint8_t>(t_value | 0x80));
+        t_value >>= 7;
+    }
+    t_out.push_back(static_cast<std::uint8_t>(t_value));
+}
+
+// Advances t_data past the varint; false if it runs past t_end or is
+// longer than 64 bits.
+inline bool get_varint(std::uint8_t const*& t_data, std::uint8_t const* t_end,
+                       std::uint64_t& t_value)
+{
+    t_value = 0;
+
+    for(int shift = 0; shift < 64 && t_data != t_end; shift += 7) {
+        std::uint8_t const byte = *t_data++;
+        t_value |= std::uint64_t{ byte & 0x7Fu } << shift;
+
+        if((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Same, for a value that must fit in a non-negative int.
+inline bool get_varint(std::uint8_t const*& t_data, std::uint8_t const* t_end, int& t_value)
+{
+    std::uint64_t value{ 0 };
+
+    if(!get_varint(t_data, t_end, value) ||
+       value > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+        return false;
+    }
+
+    t_value = static_cast<int>(value);
+    return true;
+}
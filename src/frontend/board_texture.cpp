@@ -0,0 +1,159 @@
+#include "frontend/board_texture.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Marked rows beyond which one rectangle around them all is uploaded
+    // instead of a call per row.
+    std::size_t constexpr max_row_uploads{ 32 };
+    // Fewest cells shown across the shorter side at the deepest zoom.
+    double constexpr min_visible_cells{ 8.0 };
+
+    std::uint32_t to_argb(SDL_Color const& t_color) noexcept
+    {
+        return std::uint32_t{ t_color.a } << 24 | std::uint32_t{ t_color.r } << 16 |
+               std::uint32_t{ t_color.g } << 8 | t_color.b;
+    }
+}
+
+board_texture_t::board_texture_t(SDL_Renderer* t_renderer, int const t_rows, int const t_cols,
+                                 std::array<SDL_Color, field_base_t::CELL_TYPE_COUNT> const& t_palette,
+                                 int const t_view_width, int const t_view_height) noexcept
+    : m_renderer{ t_renderer }
+    , m_rows{ t_rows }
+    , m_cols{ t_cols }
+    , m_pixels(std::size_t(t_rows) * t_cols)
+    , m_dirty_from(t_rows, 0)
+    , m_dirty_to(t_rows, 0)
+    , m_view_width{ t_view_width }
+    , m_view_height{ t_view_height }
+{
+    for(std::size_t cell = 0; cell < m_palette.size(); ++cell) {
+        m_palette[cell] = to_argb(t_palette[cell]);
+    }
+    std::fill(m_pixels.begin(), m_pixels.end(), m_palette[field_base_t::EMPTY]);
+    m_dirty_rows.reserve(t_rows);
+
+    // Textures take the scale quality set when they are created.
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    m_texture = SDL_CreateTexture(
+        m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+        m_cols, m_rows
+    );
+
+    m_fit_scale = std::min(double(m_view_width) / m_cols, double(m_view_height) / m_rows);
+    m_scale = m_fit_scale;
+    this->clamp_view();
+}
+
+board_texture_t::~board_texture_t() noexcept
+{
+    if(m_texture != nullptr) {
+        SDL_DestroyTexture(m_texture);
+    }
+}
+
+void board_texture_t::clear_screen()
+{
+    std::fill(m_pixels.begin(), m_pixels.end(), m_palette[field_base_t::EMPTY]);
+    m_all_dirty = true;
+}
+
+void board_texture_t::upload()
+{
+    int const pitch = m_cols * static_cast<int>(sizeof(std::uint32_t));
+
+    if(m_all_dirty) {
+        SDL_UpdateTexture(m_texture, nullptr, m_pixels.data(), pitch);
+    }
+    else if(m_dirty_rows.size() > max_row_uploads) {
+        SDL_Rect area{ m_cols, m_rows, 0, 0 };
+        int right{ 0 };
+        int bottom{ 0 };
+
+        for(int const row : m_dirty_rows) {
+            area.x = std::min(area.x, m_dirty_from[row]);
+            area.y = std::min(area.y, row);
+            right = std::max(right, m_dirty_to[row]);
+            bottom = std::max(bottom, row + 1);
+        }
+        area.w = right - area.x;
+        area.h = bottom - area.y;
+
+        SDL_UpdateTexture(m_texture, &area,
+                          m_pixels.data() + std::size_t(area.y) * m_cols + area.x, pitch);
+    }
+    else {
+        for(int const row : m_dirty_rows) {
+            SDL_Rect const span{ m_dirty_from[row], row, m_dirty_to[row] - m_dirty_from[row], 1 };
+            SDL_UpdateTexture(m_texture, &span,
+                              m_pixels.data() + std::size_t(row) * m_cols + span.x, pitch);
+        }
+    }
+
+    for(int const row : m_dirty_rows) {
+        m_dirty_to[row] = m_dirty_from[row];
+    }
+    m_dirty_rows.clear();
+    m_all_dirty = false;
+}
+
+void board_texture_t::present()
+{
+    this->upload();
+
+    // The whole cells that are at least partly visible, placed so that
+    // m_left and m_top land on the window's corner.
+    double const right = m_left + m_view_width / m_scale;
+    double const bottom = m_top + m_view_height / m_scale;
+
+    SDL_Rect source;
+    source.x = std::max(0, static_cast<int>(std::floor(m_left)));
+    source.y = std::max(0, static_cast<int>(std::floor(m_top)));
+    source.w = std::min(m_cols, static_cast<int>(std::ceil(right))) - source.x;
+    source.h = std::min(m_rows, static_cast<int>(std::ceil(bottom))) - source.y;
+
+    SDL_Rect target;
+    target.x = static_cast<int>(std::lround((source.x - m_left) * m_scale));
+    target.y = static_cast<int>(std::lround((source.y - m_top) * m_scale));
+    target.w = static_cast<int>(std::lround((source.x + source.w - m_left) * m_scale)) - target.x;
+    target.h = static_cast<int>(std::lround((source.y + source.h - m_top) * m_scale)) - target.y;
+
+    SDL_RenderCopy(m_renderer, m_texture, &source, &target);
+}
+
+void board_texture_t::clamp_view() noexcept
+{
+    double const visible_cols = m_view_width / m_scale;
+    double const visible_rows = m_view_height / m_scale;
+
+    // A board narrower than the window is centred; otherwise the view
+    // stays on it.
+    m_left = visible_cols >= m_cols ? (m_cols - visible_cols) / 2
+                                    : std::min(std::max(0.0, m_left), m_cols - visible_cols);
+    m_top = visible_rows >= m_rows ? (m_rows - visible_rows) / 2
+                                   : std::min(std::max(0.0, m_top), m_rows - visible_rows);
+}
+
+void board_texture_t::zoom(double const t_factor, int const t_x, int const t_y) noexcept
+{
+    double const deepest = std::min(m_view_width, m_view_height) / min_visible_cells;
+    double const scale = std::min(std::max(m_fit_scale, m_scale * t_factor),
+                                  std::max(m_fit_scale, deepest));
+
+    double const anchor_j = m_left + t_x / m_scale;
+    double const anchor_i = m_top + t_y / m_scale;
+
+    m_scale = scale;
+    m_left = anchor_j - t_x / m_scale;
+    m_top = anchor_i - t_y / m_scale;
+    this->clamp_view();
+}
+
+void board_texture_t::pan(int const t_dx, int const t_dy) noexcept
+{
+    m_left -= t_dx / m_scale;
+    m_top -= t_dy / m_scale;
+    this->clamp_view();
+}
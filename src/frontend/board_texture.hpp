@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "SDL2/SDL.h"
+
+#include "core/cell_storage.hpp"
+#include "core/position.hpp"
+
+// The board as a streaming texture with one pixel per cell, for boards
+// too big for a rectangle per cell. draw() only writes the pixel in
+// memory and marks its row; upload() sends the changed span of each
+// marked row with SDL_UpdateTexture (or one rectangle around them all if
+// there are many), so a tick costs a few tiny uploads however long the
+// snakes are. present() scales the visible part to the window in a single
+// SDL_RenderCopy, with nearest-neighbour filtering, after zoom() and
+// pan() have moved the view.
+//
+// It has the same clear_screen() and draw(position_t, cell_type) as
+// window_t, so game_field_t::draw and dirty_cells_t draw into it directly.
+struct board_texture_t
+{
+private:
+    SDL_Renderer* m_renderer{ nullptr };
+    SDL_Texture* m_texture{ nullptr };
+
+    int m_rows{ 0 };
+    int m_cols{ 0 };
+
+    std::array<std::uint32_t, field_base_t::CELL_TYPE_COUNT> m_palette{};
+    std::vector<std::uint32_t> m_pixels;
+
+    // Changed columns [m_dirty_from[i], m_dirty_to[i]) of each row listed
+    // in m_dirty_rows; a clean row has an empty span.
+    std::vector<int> m_dirty_from;
+    std::vector<int> m_dirty_to;
+    std::vector<int> m_dirty_rows;
+    bool m_all_dirty{ true };
+
+    // Window pixels per cell and the cell at the top-left window corner.
+    double m_scale{ 1.0 };
+    double m_fit_scale{ 1.0 };
+    double m_left{ 0.0 };
+    double m_top{ 0.0 };
+    int m_view_width{ 0 };
+    int m_view_height{ 0 };
+
+    void clamp_view() noexcept;
+
+public:
+    board_texture_t() noexcept = delete;
+    board_texture_t(SDL_Renderer* t_renderer, int const t_rows, int const t_cols,
+                    std::array<SDL_Color, field_base_t::CELL_TYPE_COUNT> const& t_palette,
+                    int const t_view_width, int const t_view_height) noexcept;
+    board_texture_t(board_texture_t const&) = delete;
+    board_texture_t& operator=(board_texture_t const&) = delete;
+    ~board_texture_t() noexcept;
+
+    // False if the renderer could not make a texture this big (see
+    // SDL_RendererInfo::max_texture_width); nothing else may be called then.
+    inline bool valid() const noexcept
+    { return m_texture != nullptr; }
+
+    void clear_screen();
+    inline void draw(position_t const& t_pos, field_base_t::cell_type const t_cell)
+    {
+        m_pixels[std::size_t(t_pos.i) * m_cols + t_pos.j] = m_palette[t_cell];
+
+        if(m_all_dirty) {
+            return;
+        }
+        if(m_dirty_from[t_pos.i] >= m_dirty_to[t_pos.i]) {
+            m_dirty_rows.push_back(t_pos.i);
+            m_dirty_from[t_pos.i] = t_pos.j;
+            m_dirty_to[t_pos.i] = t_pos.j + 1;
+        }
+        else {
+            m_dirty_from[t_pos.i] = std::min(m_dirty_from[t_pos.i], t_pos.j);
+            m_dirty_to[t_pos.i] = std::max(m_dirty_to[t_pos.i], t_pos.j + 1);
+        }
+    }
+
+    // Sends every pixel changed since the last upload to the texture.
+    void upload();
+    // Uploads, then copies the visible cells onto the current render
+    // target, which must be the window.
+    void present();
+
+    // Multiplies the zoom by t_factor (never below fitting the whole
+    // board), keeping the cell under window pixel (t_x, t_y) in place.
+    void zoom(double const t_factor, int const t_x, int const t_y) noexcept;
+    // Moves the view by (t_dx, t_dy) window pixels.
+    void pan(int const t_dx, int const t_dy) noexcept;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "core/position.hpp"
+#include "core/tick_delta.hpp"
+
+// Cells changed since the last presented frame. Starts out (and is reset
+// by invalidate()) asking for a full redraw.
+struct dirty_cells_t
+{
+private:
+    std::vector<position_t> m_cells;
+    bool m_everything{ true };
+
+public:
+    dirty_cells_t()
+    { m_cells.reserve(16); }
+    ~dirty_cells_t() noexcept = default;
+
+    inline void invalidate()
+    { m_everything = true; }
+
+    void add(tick_delta_t const& t_delta)
+    {
+        if(m_everything) {
+            return;
+        }
+
+        t_delta.for_each_cell([this](position_t const& t_pos) {
+            m_cells.push_back(t_pos);
+        });
+    }
+
+    inline void add(position_t const& t_pos)
+    {
+        if(!m_everything) {
+            m_cells.push_back(t_pos);
+        }
+    }
+
+    inline bool empty() const
+    { return !m_everything && m_cells.empty(); }
+
+    // Draws what changed onto t_window and forgets it. Returns false when
+    // there was nothing to draw, in which case the frame need not be
+    // presented.
+    template<typename Field, typename Window>
+    bool redraw(Field const& t_field, Window& t_window)
+    {
+        if(this->empty()) {
+            return false;
+        }
+
+        if(m_everything) {
+            t_field.draw(t_window);
+        }
+        else {
+            for(auto const& pos : m_cells) {
+                t_field.draw_cell(t_window, pos);
+            }
+        }
+
+        m_cells.clear();
+        m_everything = false;
+        return true;
+    }
+};
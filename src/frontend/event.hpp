@@ -0,0 +1,155 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+#include "SDL2/SDL.h"
+
+#include "core/spsc_queue.hpp"
+#include "core/trace.hpp"
+
+struct key_press_t
+{
+    SDL_Scancode key{ SDL_SCANCODE_UNKNOWN };
+    // SDL_KeyboardEvent::timestamp, in SDL_GetTicks() milliseconds.
+    std::uint32_t timestamp{ 0 };
+};
+
+// Mouse input that moves a board_texture_t's view, summed since it was
+// last consumed.
+struct view_input_t
+{
+    // Wheel notches, positive away from the user.
+    int wheel{ 0 };
+    // Pointer motion with the left button held.
+    int drag_x{ 0 };
+    int drag_y{ 0 };
+    // Where the pointer last was.
+    int x{ 0 };
+    int y{ 0 };
+};
+
+struct event_t
+{
+private:
+    bool m_quit{ false };
+    bool m_redraw_requested{ false };
+
+    std::bitset<SDL_NUM_SCANCODES> m_keys_held;
+
+    // Every key press, in order, until the game loop consumes it, so two
+    // presses within one tick both take effect. Auto-repeat is ignored.
+    spsc_queue_t<key_press_t, 32> m_key_presses;
+
+    view_input_t m_view_input{};
+    bool m_view_moved{ false };
+
+public:
+    event_t() = default;
+    ~event_t() noexcept = default;
+
+    void handle(SDL_Event const& t_event)
+    {
+        switch(t_event.type) {
+            case SDL_QUIT:
+                m_quit = true;
+                break;
+            case SDL_WINDOWEVENT:
+                if(t_event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                    m_redraw_requested = true;
+                }
+                break;
+            case SDL_RENDER_TARGETS_RESET:
+                m_redraw_requested = true;
+                break;
+            case SDL_KEYDOWN:
+                m_keys_held.set(t_event.key.keysym.scancode);
+                if(t_event.key.repeat == 0) {
+                    m_key_presses.push({
+                        t_event.key.keysym.scancode, t_event.key.timestamp
+                    });
+                }
+                break;
+            case SDL_KEYUP:
+                m_keys_held.reset(t_event.key.keysym.scancode);
+                break;
+            case SDL_MOUSEWHEEL:
+                m_view_input.wheel += t_event.wheel.y;
+                m_view_moved = true;
+                break;
+            case SDL_MOUSEMOTION:
+                m_view_input.x = t_event.motion.x;
+                m_view_input.y = t_event.motion.y;
+                if((t_event.motion.state & SDL_BUTTON_LMASK) != 0) {
+                    m_view_input.drag_x += t_event.motion.xrel;
+                    m_view_input.drag_y += t_event.motion.yrel;
+                    m_view_moved = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void poll_events()
+    {
+        SNAKE_TRACE_ZONE("event_t::poll_events");
+        SDL_Event event;
+
+        while(SDL_PollEvent(&event)) {
+            this->handle(event);
+        }
+    }
+
+    // Sleeps until an event arrives or t_timeout_ms passes, then handles
+    // everything that is queued.
+    void wait_events(int const t_timeout_ms)
+    {
+        SDL_Event event;
+
+        if(SDL_WaitEventTimeout(&event, t_timeout_ms)) {
+            this->handle(event);
+        }
+
+        this->poll_events();
+    }
+
+    inline void clear_key_presses()
+    {
+        key_press_t press{};
+        while(m_key_presses.pop(press)) {}
+    }
+
+    // Takes the oldest key press not consumed yet.
+    inline bool pop_key_press(key_press_t& t_press)
+    { return m_key_presses.pop(t_press); }
+    constexpr bool quit() const
+    { return m_quit; }
+
+    // True once after the window contents were lost or uncovered.
+    inline bool consume_redraw_request()
+    {
+        bool const requested = m_redraw_requested;
+        m_redraw_requested = false;
+        return requested;
+    }
+
+    // True, with the input in t_input, if the view was zoomed or dragged
+    // since the last call.
+    inline bool consume_view_input(view_input_t& t_input)
+    {
+        if(!m_view_moved) {
+            return false;
+        }
+
+        t_input = m_view_input;
+        m_view_input.wheel = 0;
+        m_view_input.drag_x = 0;
+        m_view_input.drag_y = 0;
+        m_view_moved = false;
+        return true;
+    }
+
+    inline bool is_key_held(SDL_Scancode const t_key) const
+    { return m_keys_held.test(t_key); }
+};
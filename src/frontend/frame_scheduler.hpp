@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Decides when the game loop has something to do. Logic runs on a fixed
+// timestep: consume_ticks() reports every tick that fell due since the last
+// call (catching up after a slow frame, up to a limit), and the time not
+// yet worth a whole tick carries over instead of being discarded, so the
+// tick rate does not drift with frame jitter. interpolation() is how far
+// into the next tick the clock is, for tweening. Frames are presented no
+// more often than the frame cap, and everything in between is spent
+// blocked in event_t::wait_events() instead of spinning on SDL_GetTicks().
+struct frame_scheduler_t
+{
+private:
+    std::int64_t m_tick_interval_ms{ 160 };
+    std::int64_t m_frame_interval_ms{ 0 };
+    int m_max_catch_up{ 5 };
+
+    std::int64_t m_next_tick_ms{ 0 };
+    std::int64_t m_last_frame_ms{ 0 };
+
+public:
+    frame_scheduler_t() noexcept = delete;
+    frame_scheduler_t(std::int64_t const t_now_ms,
+                      std::int64_t const t_tick_interval_ms,
+                      int const t_frame_cap) noexcept
+        : m_tick_interval_ms{ t_tick_interval_ms }
+        , m_frame_interval_ms{ t_frame_cap > 0 ? 1000 / t_frame_cap : 0 }
+        , m_next_tick_ms{ t_now_ms + t_tick_interval_ms }
+        , m_last_frame_ms{ t_now_ms - m_frame_interval_ms }
+    {}
+    ~frame_scheduler_t() noexcept = default;
+
+    // How long the loop may sleep before a tick, or a pending frame, is
+    // due. Never negative.
+    std::int64_t time_until_due(std::int64_t const t_now_ms,
+                                bool const t_frame_pending) const noexcept
+    {
+        std::int64_t wait = m_next_tick_ms - t_now_ms;
+
+        if(t_frame_pending) {
+            wait = std::min(wait, m_last_frame_ms + m_frame_interval_ms - t_now_ms);
+        }
+
+        return std::max<std::int64_t>(wait, 0);
+    }
+
+    // Number of ticks to run now. When the loop fell more than
+    // m_max_catch_up ticks behind, the excess is dropped (keeping the tick
+    // phase) rather than simulated in one burst.
+    int consume_ticks(std::int64_t const t_now_ms) noexcept
+    {
+        int ticks{ 0 };
+
+        while(t_now_ms >= m_next_tick_ms && ticks < m_max_catch_up) {
+            m_next_tick_ms += m_tick_interval_ms;
+            ++ticks;
+        }
+
+        if(t_now_ms >= m_next_tick_ms) {
+            std::int64_t const behind = t_now_ms - m_next_tick_ms;
+            m_next_tick_ms += (behind / m_tick_interval_ms + 1) * m_tick_interval_ms;
+        }
+
+        return ticks;
+    }
+
+    // In [0, 1]: 0 right after a tick, approaching 1 as the next one nears.
+    double interpolation(std::int64_t const t_now_ms) const noexcept
+    {
+        double const remaining =
+            static_cast<double>(m_next_tick_ms - t_now_ms) / m_tick_interval_ms;
+        return std::min(1.0, std::max(0.0, 1.0 - remaining));
+    }
+
+    bool consume_frame(std::int64_t const t_now_ms) noexcept
+    {
+        if(t_now_ms - m_last_frame_ms < m_frame_interval_ms) {
+            return false;
+        }
+
+        m_last_frame_ms = t_now_ms;
+        return true;
+    }
+};
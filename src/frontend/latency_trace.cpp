@@ -0,0 +1,83 @@
+#include "frontend/latency_trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+latency_trace_t::latency_trace_t()
+{
+    m_samples.reserve(4096);
+    m_scratch.reserve(window);
+}
+
+void latency_trace_t::on_consumed(std::uint32_t const t_event_ms,
+                                  std::uint64_t const t_tick,
+                                  std::uint32_t const t_now_ms) noexcept
+{
+    if(m_pending_count == m_pending.size()) {
+        return;
+    }
+
+    latency_sample_t& sample = m_pending[m_pending_count++];
+    sample.event_ms = t_event_ms;
+    sample.tick = t_tick;
+    sample.consumed_ms = t_now_ms;
+}
+
+bool latency_trace_t::on_presented(std::uint32_t const t_now_ms)
+{
+    if(m_pending_count == 0) {
+        return false;
+    }
+
+    for(std::size_t k = 0; k < m_pending_count; ++k) {
+        m_pending[k].presented_ms = t_now_ms;
+        m_samples.push_back(m_pending[k]);
+    }
+
+    m_pending_count = 0;
+    return true;
+}
+
+std::uint32_t latency_trace_t::percentile(double const t_percentile)
+{
+    if(m_samples.empty()) {
+        return 0;
+    }
+
+    std::size_t const count = std::min(window, m_samples.size());
+
+    m_scratch.clear();
+    for(std::size_t k = m_samples.size() - count; k < m_samples.size(); ++k) {
+        m_scratch.push_back(m_samples[k].input_to_photon_ms());
+    }
+
+    auto const rank = static_cast<std::size_t>(
+        std::clamp(t_percentile, 0.0, 100.0) / 100.0 * (count - 1) + 0.5
+    );
+    std::nth_element(m_scratch.begin(), m_scratch.begin() + rank,
+                     m_scratch.end());
+
+    return m_scratch[rank];
+}
+
+bool latency_trace_t::dump(char const* t_path) const
+{
+    std::FILE* file = std::fopen(t_path, "w");
+    if(file == nullptr) {
+        return false;
+    }
+
+    std::fprintf(file, "event_ms,tick,consumed_ms,presented_ms,input_to_photon_ms\n");
+    for(auto const& sample : m_samples) {
+        std::fprintf(
+            file, "%u,%llu,%u,%u,%u\n",
+            static_cast<unsigned>(sample.event_ms),
+            static_cast<unsigned long long>(sample.tick),
+            static_cast<unsigned>(sample.consumed_ms),
+            static_cast<unsigned>(sample.presented_ms),
+            static_cast<unsigned>(sample.input_to_photon_ms())
+        );
+    }
+
+    return std::fclose(file) == 0;
+}
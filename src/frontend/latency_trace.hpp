@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Follows each key press that turned the snake from its SDL event
+// timestamp, through the tick that consumed it, to the SDL_RenderPresent
+// that first showed the result. All times are SDL_GetTicks() milliseconds.
+struct latency_sample_t
+{
+    std::uint32_t event_ms{ 0 };
+    std::uint64_t tick{ 0 };
+    std::uint32_t consumed_ms{ 0 };
+    std::uint32_t presented_ms{ 0 };
+
+    constexpr std::uint32_t input_to_photon_ms() const noexcept
+    { return presented_ms - event_ms; }
+};
+
+struct latency_trace_t
+{
+public:
+    // Percentiles are taken over this many of the most recent samples.
+    static std::size_t constexpr window{ 256 };
+
+private:
+    std::vector<latency_sample_t> m_samples;
+
+    // Consumed by a tick but not presented yet; several ticks can run
+    // before one frame when the loop catches up.
+    std::array<latency_sample_t, 8> m_pending{};
+    std::size_t m_pending_count{ 0 };
+
+    std::vector<std::uint32_t> m_scratch;
+
+public:
+    latency_trace_t();
+    ~latency_trace_t() noexcept = default;
+
+    void on_consumed(std::uint32_t const t_event_ms, std::uint64_t const t_tick,
+                     std::uint32_t const t_now_ms) noexcept;
+    // Returns true if this present completed at least one sample.
+    bool on_presented(std::uint32_t const t_now_ms);
+
+    inline std::size_t size() const
+    { return m_samples.size(); }
+
+    // t_percentile in [0, 100], over the last `window` samples; 0 when
+    // there are none.
+    std::uint32_t percentile(double const t_percentile);
+
+    // Writes every sample as CSV. Returns false if the file can't be
+    // written.
+    bool dump(char const* t_path) const;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "core/globals.hpp"
+
+// Everything ioana accepts on the command line.
+struct game_options_t
+{
+    std::uint64_t seed{ std::random_device{}() };
+    int width{ globals::field_width };
+    int height{ globals::field_height };
+
+    bool vsync{ false };
+    // Tween the head and tail between ticks; presents every frame. Not
+    // available with the board texture.
+    bool smooth{ false };
+    // Draw the board as a texture with one pixel per cell, zoomed with the
+    // mouse wheel and panned by dragging. Used anyway when the board has
+    // more cells across than the window has pixels.
+    bool board_texture{ false };
+
+    // Show p50/p99 input-to-photon latency in the overlay.
+    bool latency_overlay{ false };
+    // CSV file the latency samples are written to after each game.
+    char const* latency_log{ nullptr };
+    // Show tick, draw and present times and per-tick counts in the
+    // overlay from the start; F3 toggles it either way.
+    bool perf_overlay{ false };
+    // File the perf counters are written to after each game, as JSON if
+    // the name ends in .json and as CSV otherwise.
+    char const* perf_log{ nullptr };
+    // Chrome trace JSON file every trace zone so far is written to after
+    // each game; needs a -DSNAKE_TRACE=CHROME build.
+    char const* trace_path{ nullptr };
+    // Upper bound on presented frames per second; 0 means uncapped.
+    int frame_cap{ 60 };
+
+    // Steer with autopilot_t instead of the arrow keys; Escape still quits.
+    bool autopilot{ false };
+
+    // Replay file each game is recorded to (the last game wins).
+    char const* record_path{ nullptr };
+    // Replay file played back instead of reading the arrow keys; its seed
+    // and board size replace --seed, --width and --height.
+    char const* replay_path{ nullptr };
+
+    static game_options_t parse(int const t_argc, char** t_argv)
+    {
+        game_options_t options{};
+
+        for(int k = 1; k < t_argc; ++k) {
+            char const* const arg = t_argv[k];
+            char const* const value = (k + 1 < t_argc) ? t_argv[k + 1] : nullptr;
+
+            if(std::strcmp(arg, "--vsync") == 0) {
+                options.vsync = true;
+            }
+            else if(std::strcmp(arg, "--smooth") == 0) {
+                options.smooth = true;
+            }
+            else if(std::strcmp(arg, "--texture") == 0) {
+                options.board_texture = true;
+            }
+            else if(std::strcmp(arg, "--latency") == 0) {
+                options.latency_overlay = true;
+            }
+            else if(std::strcmp(arg, "--perf") == 0) {
+                options.perf_overlay = true;
+            }
+            else if(std::strcmp(arg, "--autopilot") == 0) {
+                options.autopilot = true;
+            }
+            else if(value == nullptr) {
+                break;
+            }
+            else if(std::strcmp(arg, "--seed") == 0) {
+                options.seed = std::strtoull(value, nullptr, 10);
+                ++k;
+            }
+            else if(std::strcmp(arg, "--width") == 0) {
+                options.width = std::max(2, std::atoi(value));
+                ++k;
+            }
+            else if(std::strcmp(arg, "--height") == 0) {
+                options.height = std::max(2, std::atoi(value));
+                ++k;
+            }
+            else if(std::strcmp(arg, "--latency-log") == 0) {
+                options.latency_log = value;
+                ++k;
+            }
+            else if(std::strcmp(arg, "--perf-log") == 0) {
+                options.perf_log = value;
+                ++k;
+            }
+            else if(std::strcmp(arg, "--trace") == 0) {
+                options.trace_path = value;
+                ++k;
+            }
+            else if(std::strcmp(arg, "--record") == 0) {
+                options.record_path = value;
+                ++k;
+            }
+            else if(std::strcmp(arg, "--replay") == 0) {
+                options.replay_path = value;
+                ++k;
+            }
+            else if(std::strcmp(arg, "--fps") == 0) {
+                options.frame_cap = std::max(0, std::atoi(value));
+                ++k;
+            }
+        }
+
+        return options;
+    }
+};
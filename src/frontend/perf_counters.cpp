@@ -0,0 +1,167 @@
+#include "frontend/perf_counters.hpp"
+
+#include "core/trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::uint64_t> g_allocations{ 0 };
+
+    char const* const metric_names[PERF_METRIC_COUNT] = {
+        "tick_us", "draw_us", "present_us",
+        "frames_per_tick", "allocations_per_tick", "fruits_per_tick"
+    };
+
+    std::size_t bucket_of(std::uint32_t t_value) noexcept
+    {
+        std::size_t bucket{ 0 };
+        while(t_value != 0 && bucket + 1 < perf_counters_t::bucket_count) {
+            t_value >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+}
+
+// Replaced for the whole program so allocations show up per tick; the
+// nothrow and array forms end up here too. The trace buffers' own
+// allocations are left out.
+void* operator new(std::size_t const t_size)
+{
+    if(!trace_allocating()) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* const memory = std::malloc(t_size == 0 ? 1 : t_size);
+    if(memory == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return memory;
+}
+
+void operator delete(void* t_memory) noexcept
+{ std::free(t_memory); }
+
+void operator delete(void* t_memory, std::size_t) noexcept
+{ std::free(t_memory); }
+
+std::uint64_t allocation_count() noexcept
+{ return g_allocations.load(std::memory_order_relaxed); }
+
+char const* perf_counters_t::name(perf_metric const t_metric) noexcept
+{ return metric_names[t_metric]; }
+
+void perf_counters_t::add(perf_metric const t_metric, std::uint32_t const t_value) noexcept
+{
+    series_t& series = m_series[t_metric];
+
+    series.recent[series.next] = t_value;
+    series.next = (series.next + 1) % window;
+    ++series.count;
+    series.total += t_value;
+    series.max = std::max(series.max, t_value);
+}
+
+perf_summary_t perf_counters_t::summary(perf_metric const t_metric) const
+{
+    series_t const& series = m_series[t_metric];
+    perf_summary_t summary{};
+
+    if(series.count == 0) {
+        return summary;
+    }
+
+    auto const count = static_cast<std::size_t>(std::min<std::uint64_t>(window, series.count));
+    m_scratch.assign(series.recent.begin(), series.recent.begin() + count);
+
+    auto const rank = [count](double const t_percentile) {
+        return static_cast<std::size_t>(t_percentile / 100.0 * (count - 1) + 0.5);
+    };
+    auto const at = [this](std::size_t const t_rank) {
+        std::nth_element(m_scratch.begin(), m_scratch.begin() + t_rank, m_scratch.end());
+        return m_scratch[t_rank];
+    };
+
+    summary.count = series.count;
+    summary.mean = double(series.total) / series.count;
+    summary.p50 = at(rank(50.0));
+    summary.p90 = at(rank(90.0));
+    summary.p99 = at(rank(99.0));
+    summary.max = series.max;
+    return summary;
+}
+
+perf_counters_t::histogram_type perf_counters_t::histogram(perf_metric const t_metric) const noexcept
+{
+    series_t const& series = m_series[t_metric];
+    histogram_type histogram{};
+
+    auto const count = static_cast<std::size_t>(std::min<std::uint64_t>(window, series.count));
+    for(std::size_t k = 0; k < count; ++k) {
+        ++histogram[bucket_of(series.recent[k])];
+    }
+    return histogram;
+}
+
+bool perf_counters_t::write_csv(char const* t_path) const
+{
+    std::FILE* file = std::fopen(t_path, "w");
+    if(file == nullptr) {
+        return false;
+    }
+
+    // The histogram is the rolling window's bucket counts, ';' separated.
+    std::fprintf(file, "metric,count,mean,p50,p90,p99,max,histogram\n");
+    for(int metric = 0; metric < PERF_METRIC_COUNT; ++metric) {
+        auto const id = static_cast<perf_metric>(metric);
+        perf_summary_t const s = this->summary(id);
+
+        std::fprintf(file, "%s,%llu,%.3f,%u,%u,%u,%u,", name(id),
+                     static_cast<unsigned long long>(s.count), s.mean,
+                     static_cast<unsigned>(s.p50), static_cast<unsigned>(s.p90),
+                     static_cast<unsigned>(s.p99), static_cast<unsigned>(s.max));
+
+        histogram_type const buckets = this->histogram(id);
+        for(std::size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+            std::fprintf(file, bucket == 0 ? "%u" : ";%u", static_cast<unsigned>(buckets[bucket]));
+        }
+        std::fprintf(file, "\n");
+    }
+
+    return std::fclose(file) == 0;
+}
+
+bool perf_counters_t::write_json(char const* t_path) const
+{
+    std::FILE* file = std::fopen(t_path, "w");
+    if(file == nullptr) {
+        return false;
+    }
+
+    // "histogram" holds the rolling window's bucket counts; bucket k is
+    // for samples below 2^k.
+    std::fprintf(file, "{\n");
+    for(int metric = 0; metric < PERF_METRIC_COUNT; ++metric) {
+        auto const id = static_cast<perf_metric>(metric);
+        perf_summary_t const s = this->summary(id);
+
+        std::fprintf(file, "  \"%s\": { \"count\": %llu, \"mean\": %.3f, \"p50\": %u, "
+                           "\"p90\": %u, \"p99\": %u, \"max\": %u, \"histogram\": [",
+                     name(id), static_cast<unsigned long long>(s.count), s.mean,
+                     static_cast<unsigned>(s.p50), static_cast<unsigned>(s.p90),
+                     static_cast<unsigned>(s.p99), static_cast<unsigned>(s.max));
+
+        histogram_type const buckets = this->histogram(id);
+        for(std::size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+            std::fprintf(file, bucket == 0 ? "%u" : ", %u", static_cast<unsigned>(buckets[bucket]));
+        }
+        std::fprintf(file, metric + 1 < PERF_METRIC_COUNT ? "] },\n" : "] }\n");
+    }
+    std::fprintf(file, "}\n");
+
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What game_loop() measures. The first three are microseconds, the rest
+// plain counts; TICK_US and the counts get one sample per tick, DRAW_US
+// and PRESENT_US one per presented frame.
+enum perf_metric
+{
+    TICK_US = 0,
+    DRAW_US,
+    PRESENT_US,
+    // Frames presented since the tick before.
+    FRAMES_PER_TICK,
+    // Calls to the global operator new during the tick.
+    ALLOCATIONS_PER_TICK,
+    // Fruits placed during the tick. Each one is a single draw from the
+    // free-cell index, so there are no placement retries to count.
+    FRUITS_PER_TICK,
+    PERF_METRIC_COUNT
+};
+
+struct perf_summary_t
+{
+    std::uint64_t count{ 0 };
+    double mean{ 0.0 };
+    std::uint32_t p50{ 0 };
+    std::uint32_t p90{ 0 };
+    std::uint32_t p99{ 0 };
+    std::uint32_t max{ 0 };
+};
+
+// Rolling statistics for every perf_metric: the last `window` samples of
+// each are kept for percentiles and a histogram, next to totals over the
+// whole game. Adding a sample never allocates.
+struct perf_counters_t
+{
+public:
+    static std::size_t constexpr window{ 1024 };
+    // Bucket k counts samples below 2^k (and at least 2^(k-1)); the last
+    // one takes everything bigger.
+    static std::size_t constexpr bucket_count{ 24 };
+
+    using clock = std::chrono::steady_clock;
+    using histogram_type = std::array<std::uint32_t, bucket_count>;
+
+private:
+    struct series_t
+    {
+        std::array<std::uint32_t, window> recent{};
+        std::size_t next{ 0 };
+        std::uint64_t count{ 0 };
+        std::uint64_t total{ 0 };
+        std::uint32_t max{ 0 };
+    };
+
+    std::array<series_t, PERF_METRIC_COUNT> m_series{};
+    mutable std::vector<std::uint32_t> m_scratch;
+
+public:
+    perf_counters_t()
+    { m_scratch.reserve(window); }
+    ~perf_counters_t() noexcept = default;
+
+    static char const* name(perf_metric const t_metric) noexcept;
+
+    static inline std::uint32_t microseconds_since(clock::time_point const t_start) noexcept
+    {
+        return static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - t_start).count()
+        );
+    }
+
+    void add(perf_metric const t_metric, std::uint32_t const t_value) noexcept;
+
+    // Percentiles over the rolling window; count, mean and max over the
+    // whole game.
+    perf_summary_t summary(perf_metric const t_metric) const;
+    histogram_type histogram(perf_metric const t_metric) const noexcept;
+
+    // One CSV row or JSON member per metric. Return false if the file
+    // can't be written.
+    bool write_csv(char const* t_path) const;
+    bool write_json(char const* t_path) const;
+};
+
+// Calls to the global operator new in this process so far; counted by the
+// replacement in perf_counters.cpp.
+std::uint64_t allocation_count() noexcept;
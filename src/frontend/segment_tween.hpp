@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/cell_storage.hpp"
+#include "core/position.hpp"
+#include "core/tick_delta.hpp"
+#include "frontend/dirty_cells.hpp"
+
+// Smooths the last tick between logic updates: the new head slides into
+// its cell and the removed tail slides out of its own, by the scheduler's
+// interpolation factor. Only those two cells are animated, so a tweened
+// frame costs the same however long the snake is.
+struct segment_tween_t
+{
+private:
+    tick_delta_t m_delta{};
+    position_t m_tail{};
+    bool m_active{ false };
+
+public:
+    segment_tween_t() noexcept = default;
+    ~segment_tween_t() noexcept = default;
+
+    inline bool active() const
+    { return m_active; }
+
+    // t_tail is the snake's tail after the tick. The cells the previous
+    // tween drew over go to t_dirty so they get repainted from the field.
+    void start(tick_delta_t const& t_delta, position_t const& t_tail,
+               dirty_cells_t& t_dirty)
+    {
+        this->stop(t_dirty);
+
+        m_delta = t_delta;
+        m_tail = t_tail;
+        m_active = (t_delta.result != snake_base_t::COLLIDED);
+    }
+
+    void stop(dirty_cells_t& t_dirty)
+    {
+        if(m_active) {
+            t_dirty.add(m_delta.new_head);
+            t_dirty.add(m_delta.tail);
+        }
+
+        m_active = false;
+    }
+
+    // Window needs draw(pos, cell) and draw(pos, cell, side, fraction),
+    // the latter filling t_fraction of the cell starting from its t_side
+    // edge. Batches are flushed in cell_type order, so the EMPTY or FRUIT
+    // backgrounds always land below the partial snake rects.
+    template<typename Window>
+    void draw(Window& t_window, double const t_alpha) const
+    {
+        if(!m_active) {
+            return;
+        }
+
+        field_base_t::cell_type const under_head =
+            (m_delta.result == snake_base_t::ATE) ? field_base_t::FRUIT
+                                                  : field_base_t::EMPTY;
+
+        t_window.draw(m_delta.new_head, under_head);
+        t_window.draw(
+            m_delta.new_head, field_base_t::SNAKE_HEAD,
+            direction_between(m_delta.new_head, m_delta.old_head), t_alpha
+        );
+
+        if(m_delta.tail_removed &&
+           (m_delta.tail.i != m_delta.new_head.i ||
+            m_delta.tail.j != m_delta.new_head.j)) {
+            t_window.draw(m_delta.tail, field_base_t::EMPTY);
+            t_window.draw(
+                m_delta.tail, field_base_t::SNAKE_BODY,
+                direction_between(m_delta.tail, m_tail), 1.0 - t_alpha
+            );
+        }
+    }
+};
@@ -0,0 +1,138 @@
+#include "frontend/text.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace {
+    struct glyph_t
+    {
+        char code;
+        char const* rows[text_renderer_t::glyph_height];
+    };
+
+    glyph_t constexpr font[] = {
+        { '0', { "###", "#.#", "#.#", "#.#", "###" } },
+        { '1', { ".#.", "##.", ".#.", ".#.", "###" } },
+        { '2', { "###", "..#", "###", "#..", "###" } },
+        { '3', { "###", "..#", ".##", "..#", "###" } },
+        { '4', { "#.#", "#.#", "###", "..#", "..#" } },
+        { '5', { "###", "#..", "###", "..#", "###" } },
+        { '6', { "###", "#..", "###", "#.#", "###" } },
+        { '7', { "###", "..#", ".#.", ".#.", ".#." } },
+        { '8', { "###", "#.#", "###", "#.#", "###" } },
+        { '9', { "###", "#.#", "###", "..#", "###" } },
+        { 'A', { ".#.", "#.#", "###", "#.#", "#.#" } },
+        { 'B', { "##.", "#.#", "##.", "#.#", "##." } },
+        { 'C', { ".##", "#..", "#..", "#..", ".##" } },
+        { 'D', { "##.", "#.#", "#.#", "#.#", "##." } },
+        { 'E', { "###", "#..", "##.", "#..", "###" } },
+        { 'F', { "###", "#..", "##.", "#..", "#.." } },
+        { 'G', { ".##", "#..", "#.#", "#.#", ".##" } },
+        { 'H', { "#.#", "#.#", "###", "#.#", "#.#" } },
+        { 'I', { "###", ".#.", ".#.", ".#.", "###" } },
+        { 'J', { "..#", "..#", "..#", "#.#", ".#." } },
+        { 'K', { "#.#", "#.#", "##.", "#.#", "#.#" } },
+        { 'L', { "#..", "#..", "#..", "#..", "###" } },
+        { 'M', { "#.#", "###", "###", "#.#", "#.#" } },
+        { 'N', { "##.", "#.#", "#.#", "#.#", "#.#" } },
+        { 'O', { ".#.", "#.#", "#.#", "#.#", ".#." } },
+        { 'P', { "##.", "#.#", "##.", "#..", "#.." } },
+        { 'Q', { ".#.", "#.#", "#.#", "##.", ".##" } },
+        { 'R', { "##.", "#.#", "##.", "#.#", "#.#" } },
+        { 'S', { ".##", "#..", ".#.", "..#", "##." } },
+        { 'T', { "###", ".#.", ".#.", ".#.", ".#." } },
+        { 'U', { "#.#", "#.#", "#.#", "#.#", "###" } },
+        { 'V', { "#.#", "#.#", "#.#", "#.#", ".#." } },
+        { 'W', { "#.#", "#.#", "###", "###", "#.#" } },
+        { 'X', { "#.#", "#.#", ".#.", "#.#", "#.#" } },
+        { 'Y', { "#.#", "#.#", ".#.", ".#.", ".#." } },
+        { 'Z', { "###", "..#", ".#.", "#..", "###" } },
+        { '.', { "...", "...", "...", "...", ".#." } },
+        { ':', { "...", ".#.", "...", ".#.", "..." } },
+        { '-', { "...", "...", "###", "...", "..." } },
+        { '/', { "..#", "..#", ".#.", "#..", "#.." } },
+        { '%', { "#.#", "..#", ".#.", "#..", "#.#" } },
+    };
+
+    int constexpr glyph_count{ sizeof(font) / sizeof(font[0]) };
+    int constexpr atlas_width{ glyph_count * text_renderer_t::glyph_width };
+
+    // Atlas column of every printable character, or -1.
+    std::array<int, 128> make_glyph_index()
+    {
+        std::array<int, 128> index{};
+        index.fill(-1);
+
+        for(int k = 0; k < glyph_count; ++k) {
+            index[static_cast<unsigned char>(font[k].code)] = k;
+        }
+
+        return index;
+    }
+
+    std::array<int, 128> const glyph_index{ make_glyph_index() };
+}
+
+text_renderer_t::text_renderer_t(SDL_Renderer* t_renderer,
+                                 int const t_scale) noexcept
+    : m_renderer{ t_renderer }
+    , m_scale{ t_scale }
+{
+    std::array<std::uint32_t, atlas_width * glyph_height> pixels{};
+
+    for(int k = 0; k < glyph_count; ++k) {
+        for(int y = 0; y < glyph_height; ++y) {
+            for(int x = 0; x < glyph_width; ++x) {
+                if(font[k].rows[y][x] == '#') {
+                    pixels[y * atlas_width + k * glyph_width + x] = 0xFFFFFFFFu;
+                }
+            }
+        }
+    }
+
+    m_atlas = SDL_CreateTexture(
+        m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+        atlas_width, glyph_height
+    );
+
+    if(m_atlas != nullptr) {
+        SDL_UpdateTexture(
+            m_atlas, nullptr, pixels.data(),
+            atlas_width * static_cast<int>(sizeof(std::uint32_t))
+        );
+        SDL_SetTextureBlendMode(m_atlas, SDL_BLENDMODE_BLEND);
+    }
+}
+
+text_renderer_t::~text_renderer_t() noexcept
+{
+    if(m_atlas != nullptr) {
+        SDL_DestroyTexture(m_atlas);
+    }
+}
+
+void text_renderer_t::draw(int const t_x, int const t_y, char const* t_text,
+                           SDL_Color const& t_color)
+{
+    if(m_atlas == nullptr) {
+        return;
+    }
+
+    SDL_SetTextureColorMod(m_atlas, t_color.r, t_color.g, t_color.b);
+
+    SDL_Rect source{ 0, 0, glyph_width, glyph_height };
+    SDL_Rect target{ t_x, t_y, glyph_width * m_scale, glyph_height * m_scale };
+
+    for(char const* c = t_text; *c != '\0'; ++c, target.x += this->advance()) {
+        unsigned char code = static_cast<unsigned char>(*c);
+        if(code >= 'a' && code <= 'z') {
+            code = static_cast<unsigned char>(code - 'a' + 'A');
+        }
+        if(code >= glyph_index.size() || glyph_index[code] < 0) {
+            continue;
+        }
+
+        source.x = glyph_index[code] * glyph_width;
+        SDL_RenderCopy(m_renderer, m_atlas, &source, &target);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SDL2/SDL.h"
+
+// Draws short ASCII strings from a glyph atlas built once at start-up from
+// a built-in 3x5 pixel font, so text costs one SDL_RenderCopy per glyph
+// and never touches a font library or the heap. Lower-case letters are
+// drawn as upper-case; characters without a glyph are left blank.
+struct text_renderer_t
+{
+public:
+    static int constexpr glyph_width{ 3 };
+    static int constexpr glyph_height{ 5 };
+
+private:
+    SDL_Renderer* m_renderer{ nullptr };
+    SDL_Texture* m_atlas{ nullptr };
+
+    int m_scale{ 3 };
+
+public:
+    text_renderer_t() noexcept = delete;
+    text_renderer_t(SDL_Renderer* t_renderer, int const t_scale) noexcept;
+    text_renderer_t(text_renderer_t const&) = delete;
+    text_renderer_t& operator=(text_renderer_t const&) = delete;
+    ~text_renderer_t() noexcept;
+
+    // Size of one glyph cell on screen, spacing included.
+    inline int advance() const
+    { return (glyph_width + 1) * m_scale; }
+    inline int line_height() const
+    { return (glyph_height + 1) * m_scale; }
+
+    void draw(int const t_x, int const t_y, char const* t_text,
+              SDL_Color const& t_color);
+};
@@ -0,0 +1,223 @@
+#include "frontend/window.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "core/trace.hpp"
+
+window_t::window_t(int const t_width, int const t_height, bool const t_vsync) noexcept
+    : m_width{ t_width }
+    , m_height{ t_height }
+    , m_vsync{ t_vsync }
+{
+    m_palette[field_base_t::EMPTY] = SDL_Color{ 0, 0, 0, 255 };
+    m_palette[field_base_t::FRUIT] = SDL_Color{ 244, 13, 45, 255 };
+    m_palette[field_base_t::SNAKE_HEAD] = SDL_Color{ 34, 120, 16, 255 };
+    m_palette[field_base_t::SNAKE_BODY] = SDL_Color{ 34, 232, 16, 255 };
+    m_palette[field_base_t::ERROR] = SDL_Color{ 255, 0, 255, 255 };
+}
+
+window_t::~window_t() noexcept
+{
+    if(m_renderer == nullptr) {
+        return;
+    }
+
+    m_text.reset();
+    m_board.reset();
+    if(m_canvas != nullptr) {
+        SDL_DestroyTexture(m_canvas);
+    }
+    SDL_DestroyRenderer(m_renderer);
+    SDL_DestroyWindow(m_window);
+
+    SDL_Quit();
+}
+
+void window_t::open()
+{
+    SDL_Init(SDL_INIT_VIDEO);
+
+    m_window = SDL_CreateWindow(
+        "Snake Game!",
+        SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+        m_width, m_height,
+        SDL_WINDOW_HIDDEN
+    );
+
+    SDL_SetWindowResizable(m_window, SDL_FALSE);
+
+    Uint32 renderer_flags{ SDL_RENDERER_ACCELERATED };
+    if(m_vsync) {
+        renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+
+    m_renderer = SDL_CreateRenderer(m_window, -1, renderer_flags);
+    m_text = std::make_unique<text_renderer_t>(m_renderer, 3);
+}
+
+void window_t::set_board(int const t_rows, int const t_cols, bool const t_board_texture)
+{
+    if(m_renderer == nullptr) {
+        this->open();
+    }
+
+    bool const same_board = t_rows == m_rows && t_cols == m_cols;
+    m_rows = t_rows;
+    m_cols = t_cols;
+
+    if(!t_board_texture || !same_board) {
+        m_board.reset();
+    }
+    if(t_board_texture && m_board == nullptr) {
+        m_board = std::make_unique<board_texture_t>(
+            m_renderer, m_rows, m_cols, m_palette, m_width, m_height
+        );
+        if(!m_board->valid()) {
+            m_board.reset();
+        }
+    }
+
+    if(m_board == nullptr && m_canvas == nullptr) {
+        m_canvas = SDL_CreateTexture(
+            m_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+            m_width, m_height
+        );
+    }
+
+    SDL_SetRenderTarget(m_renderer, m_board == nullptr ? m_canvas : nullptr);
+}
+
+void window_t::update()
+{
+    SNAKE_TRACE_ZONE("window_t::update");
+
+    this->flush();
+
+    if(m_board != nullptr) {
+        SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+        SDL_RenderClear(m_renderer);
+        m_board->present();
+    }
+    else if(m_canvas != nullptr) {
+        SDL_SetRenderTarget(m_renderer, nullptr);
+        SDL_RenderCopy(m_renderer, m_canvas, nullptr, nullptr);
+    }
+
+    int y{ m_text->line_height() / 2 };
+    for(auto const& line : m_overlay) {
+        if(line[0] != '\0') {
+            m_text->draw(m_text->advance() / 2, y, line.data(),
+                         SDL_Color{ 255, 255, 255, 255 });
+            y += m_text->line_height();
+        }
+    }
+
+    SDL_RenderPresent(m_renderer);
+
+    if(!m_shown) {
+        SDL_ShowWindow(m_window);
+        m_shown = true;
+    }
+
+    if(m_board == nullptr && m_canvas != nullptr) {
+        SDL_SetRenderTarget(m_renderer, m_canvas);
+    }
+}
+
+void window_t::set_overlay_line(std::size_t const t_line, char const* t_text)
+{
+    if(t_line >= m_overlay.size()) {
+        return;
+    }
+
+    auto& line = m_overlay[t_line];
+    std::size_t k{ 0 };
+    for(; k + 1 < line.size() && t_text[k] != '\0'; ++k) {
+        line[k] = t_text[k];
+    }
+    line[k] = '\0';
+}
+
+void window_t::clear_screen()
+{
+    for(auto& batch : m_batches) {
+        batch.clear();
+    }
+
+    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(m_renderer);
+}
+
+SDL_Rect window_t::cell_rect(position_t const& t_pos) const
+{
+    SDL_Rect rect;
+
+    rect.h = std::max(1, m_height / m_rows);
+    rect.w = std::max(1, m_width / m_cols);
+    rect.x = t_pos.j * rect.w;
+    rect.y = t_pos.i * rect.h;
+
+    return rect;
+}
+
+void window_t::draw(position_t const& t_pos,
+                    field_base_t::cell_type const t_cell,
+                    direction_type const t_side, double const t_fraction)
+{
+    SDL_Rect rect = this->cell_rect(t_pos);
+    double const fraction = std::min(1.0, std::max(0.0, t_fraction));
+
+    switch(t_side) {
+        case UP:
+            rect.h = static_cast<int>(rect.h * fraction);
+            break;
+        case DOWN: {
+            int const h = static_cast<int>(rect.h * fraction);
+            rect.y += rect.h - h;
+            rect.h = h;
+            break;
+        }
+        case LEFT:
+            rect.w = static_cast<int>(rect.w * fraction);
+            break;
+        case RIGHT: {
+            int const w = static_cast<int>(rect.w * fraction);
+            rect.x += rect.w - w;
+            rect.w = w;
+            break;
+        }
+        default: break;
+    }
+
+    if(rect.w > 0 && rect.h > 0) {
+        m_batches[t_cell].push_back(rect);
+    }
+}
+
+void window_t::flush()
+{
+    for(std::size_t cell = 0; cell < m_batches.size(); ++cell) {
+        auto& batch = m_batches[cell];
+        if(batch.empty()) {
+            continue;
+        }
+
+        SDL_Color const color = m_palette[cell];
+        SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRects(
+            m_renderer, batch.data(), static_cast<int>(batch.size())
+        );
+        batch.clear();
+    }
+}
+
+void window_t::draw(position_t const& t_pos,
+                    int const t_r, int const t_g,
+                    int const t_b, int const t_a)
+{
+    SDL_Rect const rect = this->cell_rect(t_pos);
+
+    SDL_SetRenderDrawColor(m_renderer, t_r, t_g, t_b, t_a);
+    SDL_RenderFillRect(m_renderer, &rect);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SDL2/SDL.h"
+
+#include "core/cell_storage.hpp"
+#include "core/globals.hpp"
+#include "core/position.hpp"
+#include "frontend/board_texture.hpp"
+#include "frontend/text.hpp"
+
+// One window for the whole run: SDL, the window and the renderer are set
+// up by the first set_board() and kept across games, so a new game only
+// has to reset its own state. The window stays hidden until the first
+// update(), so it never shows up empty.
+struct window_t
+{
+private:
+    SDL_Window* m_window{ nullptr };
+    SDL_Renderer* m_renderer{ nullptr };
+    // Everything is drawn here and copied to the back buffer on update(),
+    // so cells that did not change need not be drawn again.
+    SDL_Texture* m_canvas{ nullptr };
+    bool m_shown{ false };
+
+    int m_width{ 900 };
+    int m_height{ 900 };
+    bool m_vsync{ false };
+
+    int m_rows{ globals::field_height };
+    int m_cols{ globals::field_width };
+
+    // Cells queued by draw(pos, cell), one batch per cell type, submitted
+    // by flush() with a single SDL_RenderFillRects call each. The vectors
+    // are cleared but never shrunk, so steady-state frames do not allocate.
+    std::array<SDL_Color, field_base_t::CELL_TYPE_COUNT> m_palette;
+    std::array<std::vector<SDL_Rect>, field_base_t::CELL_TYPE_COUNT> m_batches;
+
+    // When set, the board is drawn into it instead of as rectangles, and
+    // the canvas is not used.
+    std::unique_ptr<board_texture_t> m_board;
+
+    SDL_Rect cell_rect(position_t const& t_pos) const;
+    void open();
+
+public:
+    static std::size_t constexpr overlay_lines{ 8 };
+    static std::size_t constexpr overlay_line_length{ 64 };
+
+private:
+    // Text drawn on top of the canvas at every update(). It never goes
+    // into the canvas, so partial cell redraws cannot erase it.
+    std::unique_ptr<text_renderer_t> m_text;
+    std::array<std::array<char, overlay_line_length>, overlay_lines> m_overlay{};
+
+public:
+    window_t() noexcept = delete;
+    // Only records the size; nothing is created before set_board().
+    window_t(int const t_width, int const t_height, bool const t_vsync = false) noexcept;
+    window_t(window_t const&) = delete;
+    window_t& operator=(window_t const&) = delete;
+    ~window_t() noexcept;
+
+    // Lays the window out for a t_rows x t_cols board, drawn through
+    // board() if t_board_texture is set and the renderer can make the
+    // texture, into the window otherwise. The board texture is kept if
+    // neither the board size nor the choice changed. Everything must be
+    // drawn again afterwards.
+    void set_board(int const t_rows, int const t_cols, bool const t_board_texture);
+
+    void clear_screen();
+    void draw(position_t const& t_pos,
+              int const t_r, int const t_g,
+              int const t_b, int const t_a);
+    inline void draw(position_t const& t_pos,
+                     field_base_t::cell_type const t_cell)
+    { m_batches[t_cell].push_back(this->cell_rect(t_pos)); }
+    // Queues only t_fraction of the cell, measured from its t_side edge.
+    void draw(position_t const& t_pos, field_base_t::cell_type const t_cell,
+              direction_type const t_side, double const t_fraction);
+    void flush();
+    void update();
+
+    // False when the canvas could not be created: the back buffer is then
+    // undefined after every update() and each frame must be drawn whole.
+    inline bool keeps_contents() const
+    { return m_canvas != nullptr || m_board != nullptr; }
+
+    // The board texture asked for by set_board(), or null if it wasn't
+    // or the renderer couldn't make one; draw the board into it instead
+    // of into the window then.
+    inline board_texture_t* board() const noexcept
+    { return m_board.get(); }
+
+    inline void set_title(std::string const& t_title)
+    { SDL_SetWindowTitle(m_window, t_title.c_str()); }
+    inline void set_title(char const* t_title)
+    { SDL_SetWindowTitle(m_window, t_title); }
+
+    // Copies t_text (truncated to overlay_line_length - 1 characters) into
+    // overlay line t_line; an empty string hides the line.
+    void set_overlay_line(std::size_t const t_line, char const* t_text);
+};
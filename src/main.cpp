@@ -1,639 +1,440 @@
 #include <iostream>
-#include <cstdlib>
-#include <array>
-#include <list>
-#include <random>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <string>
-#include <map>
+#include <cstdio>
+#include <cstring>
+#include <optional>
 
 #include "SDL2/SDL.h"
 
+#include "core/autopilot.hpp"
+#include "core/globals.hpp"
+#include "core/position.hpp"
+#include "core/replay.hpp"
+#include "core/simulation.hpp"
+#include "core/trace.hpp"
+#include "frontend/dirty_cells.hpp"
+#include "frontend/event.hpp"
+#include "frontend/frame_scheduler.hpp"
+#include "frontend/latency_trace.hpp"
+#include "frontend/options.hpp"
+#include "frontend/perf_counters.hpp"
+#include "frontend/segment_tween.hpp"
+#include "frontend/window.hpp"
+
 namespace globals {
     std::int64_t constexpr max_wait_time_ms{ 160 };
-    
-    int constexpr field_width{ 10 };
-    int constexpr field_height{ 10 };
+    int constexpr window_size{ 900 };
+    // How often the perf overlay is refreshed.
+    std::int64_t constexpr perf_overlay_period_ms{ 500 };
+    // Zoom per mouse wheel notch on the board texture.
+    double constexpr zoom_step{ 1.25 };
 }
 
-struct position_t
-{
-    int i{ 0 };
-    int j{ 0 };
-
-    position_t() noexcept = default;
-    position_t(int const t_i, int const t_j) noexcept
-        : i(t_i)
-        , j(t_j)
-    {}
-    ~position_t() noexcept = default;
-};
-
-struct event_t
+struct game_logic_t
 {
 private:
-    SDL_Scancode m_last_pressed_key{ SDL_SCANCODE_G };
-    bool m_quit{ false };
-
-    std::map<SDL_Scancode, bool> m_keys_held;
- 
-public:
-    event_t() = default;
-    ~event_t() noexcept = default;
+    bool m_game_running{ true };
+    int m_score{ 0 };
 
-    void poll_events()
-    { 
-        SDL_Event event;
+    game_options_t m_options;
+    // Played back instead of the keyboard when not null.
+    replay_t const* m_replay{ nullptr };
+    // Toggled with F3.
+    bool m_perf_overlay{ false };
+
+    // Consumes queued key presses up to the first one that turns the
+    // snake; presses that would not change its course are skipped so they
+    // do not use up a tick.
+    // The press that turned the snake, if any, goes to t_consumed.
+    direction_type next_direction(event_t& t_event,
+                                  direction_type const t_current,
+                                  key_press_t* t_consumed);
+
+    // Called only when the length changes, never once per frame.
+    void show_score(window_t& t_window, std::size_t const t_length);
+    void show_latency(window_t& t_window, latency_trace_t& t_latency);
+    // Overlay lines 2 to 5; cleared while the overlay is off.
+    void show_perf(window_t& t_window, perf_counters_t const& t_perf);
 
-        while(SDL_PollEvent(&event)) {
-            switch(event.type) {
-                case SDL_QUIT:
-                    m_quit = true;
-                    break;
-                case SDL_KEYDOWN:
-                    m_last_pressed_key = event.key.keysym.scancode;
-                    m_keys_held[event.key.keysym.scancode] = true;
-                case SDL_KEYUP:
-                    m_keys_held[event.key.keysym.scancode] = false;
-                default: 
-                    break;
-            }
-        }
-    } 
-    constexpr char get_key() const
-    { return m_last_pressed_key; }
-    constexpr bool quit() const
-    { return m_quit; }
+public:
+    game_logic_t() noexcept = delete;
+    game_logic_t(game_options_t const& t_options,
+                 replay_t const* t_replay) noexcept
+        : m_options{ t_options }
+        , m_replay{ t_replay }
+        , m_perf_overlay{ t_options.perf_overlay }
+    {}
+    ~game_logic_t() noexcept = default;
 
-    bool is_key_held(SDL_Scancode t_key) 
-    {
-        if(m_keys_held.find(t_key) == m_keys_held.end()) {
-            return false;
-        }
+    // Plays one game in t_window, which is laid out for this game's board
+    // but otherwise reused as it is.
+    void game_loop(window_t& t_window, event_t& t_event);
 
-        return m_keys_held[t_key];
-    }
+    constexpr int get_score() const
+    { return m_score; }
 };
 
-struct window_t
+void game_logic_t::show_score(window_t& t_window, std::size_t const t_length)
 {
-private:
-    SDL_Window* m_window{ nullptr };
-    SDL_Renderer* m_renderer{ nullptr };
+    char text[window_t::overlay_line_length];
 
-    int m_width{ 900 };
-    int m_height{ 900 };
+    std::snprintf(text, sizeof(text), "Snake Game! Score: %zu", t_length);
+    t_window.set_title(text);
 
-public:
-    window_t() noexcept = delete;
-    window_t(int const t_width, int const t_height) noexcept;
-    ~window_t() noexcept;
-
-    void clear_screen();
-    void draw(position_t const& t_pos,
-              int const t_r, int const t_g,
-              int const t_b, int const t_a);
-    inline void update()
-    { SDL_RenderPresent(m_renderer); }
-
-    inline void set_title(std::string const& t_title)
-    { SDL_SetWindowTitle(m_window, t_title.c_str()); }
-};
+    std::snprintf(text, sizeof(text), "SCORE %zu", t_length);
+    t_window.set_overlay_line(0, text);
+}
 
-window_t::window_t(int const t_width, int const t_height) noexcept 
-    : m_width{ t_width }
-    , m_height{ t_height }
+void game_logic_t::show_latency(window_t& t_window,
+                                latency_trace_t& t_latency)
 {
-    SDL_Init(SDL_INIT_VIDEO);
-
-    m_window = SDL_CreateWindow(
-        "Snake Game!", 
-        SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-        m_width, m_height,
-        SDL_WINDOW_SHOWN
-    );
-
-    SDL_SetWindowResizable(m_window, SDL_FALSE);
+    char text[window_t::overlay_line_length];
 
-    m_renderer = SDL_CreateRenderer(
-        m_window, -1, SDL_RENDERER_ACCELERATED //| SDL_RENDERER_PRESENTVSYNC
+    std::snprintf(
+        text, sizeof(text), "LAT P50 %uMS P99 %uMS N %zu",
+        static_cast<unsigned>(t_latency.percentile(50.0)),
+        static_cast<unsigned>(t_latency.percentile(99.0)),
+        t_latency.size()
     );
+    t_window.set_overlay_line(1, text);
 }
 
-window_t::~window_t() noexcept
+void game_logic_t::show_perf(window_t& t_window, perf_counters_t const& t_perf)
 {
-    SDL_DestroyRenderer(m_renderer);
-    SDL_DestroyWindow(m_window);
+    static std::size_t constexpr first_line{ 2 };
+    char text[window_t::overlay_line_length];
 
-    SDL_Quit();
-}
+    if(!m_perf_overlay) {
+        for(std::size_t line = first_line; line < first_line + 4; ++line) {
+            t_window.set_overlay_line(line, "");
+        }
+        return;
+    }
 
-void window_t::clear_screen()
-{
-    SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
-    SDL_RenderClear(m_renderer);
-}
+    char const* const labels[] = { "TICK", "DRAW", "PRESENT" };
+    perf_metric const times[] = { TICK_US, DRAW_US, PRESENT_US };
 
-void window_t::draw(position_t const& t_pos,
-                    int const t_r, int const t_g, 
-                    int const t_b, int const t_a)
-{
-    SDL_Rect rect;
-
-    rect.x = t_pos.j * (m_width / globals::field_width);
-    rect.y = t_pos.i * (m_height / globals::field_height);
-    rect.h = m_height / globals::field_height;
-    rect.w = m_width / globals::field_width;
+    for(std::size_t k = 0; k < 3; ++k) {
+        perf_summary_t const summary = t_perf.summary(times[k]);
+        std::snprintf(text, sizeof(text), "%s P50 %uUS P99 %uUS MAX %uUS", labels[k],
+                      static_cast<unsigned>(summary.p50), static_cast<unsigned>(summary.p99),
+                      static_cast<unsigned>(summary.max));
+        t_window.set_overlay_line(first_line + k, text);
+    }
 
-    SDL_SetRenderDrawColor(m_renderer, t_r, t_g, t_b, t_a);
-    SDL_RenderFillRect(m_renderer, &rect);
+    std::snprintf(text, sizeof(text), "FRAMES/TICK %.2f ALLOC/TICK %.2f FRUIT/TICK %.2f",
+                  t_perf.summary(FRAMES_PER_TICK).mean,
+                  t_perf.summary(ALLOCATIONS_PER_TICK).mean,
+                  t_perf.summary(FRUITS_PER_TICK).mean);
+    t_window.set_overlay_line(first_line + 3, text);
 }
 
-struct game_field_t
+direction_type game_logic_t::next_direction(event_t& t_event,
+                                            direction_type const t_current,
+                                            key_press_t* t_consumed)
 {
-public:
-    static int constexpr width{ globals::field_width };
-    static int constexpr height{ globals::field_height };
-
-    enum cell_type
-    {
-        EMPTY = 0,
-        SNAKE_HEAD,
-        SNAKE_BODY,
-        FRUIT,
-        ERROR
-    };
-
-private:
-    template<typename T, int Rows, int Cols>
-    using matrix = std::array<std::array<T, Cols>, Rows>;
-
-    matrix<cell_type, height, width> m_field;
-
-    inline void clear_screen()
-    { std::system("clear"); }
-
-public:
-    game_field_t() noexcept;
-    ~game_field_t() noexcept = default;
-
-    constexpr cell_type operator()(int const t_i, int const t_j) const
-    { return m_field[t_i][t_j]; }
-    cell_type& operator()(int const t_i, int const t_j) 
-    { return m_field[t_i][t_j]; }
-
-    cell_type at(int const t_i, int const t_j) const
-    {
-        if(t_i >= width || t_i < 0 || t_j >= height || t_j < 0) {
-            return ERROR; 
-        } 
-
-        return this->operator()(t_i, t_j);
-    }
+    key_press_t press{};
+
+    while(t_event.pop_key_press(press)) {
+        direction_type direction{ t_current };
+
+        switch(press.key) {
+            case SDL_SCANCODE_UP: direction = UP; break;
+            case SDL_SCANCODE_LEFT: direction = LEFT; break;
+            case SDL_SCANCODE_DOWN: direction = DOWN; break;
+            case SDL_SCANCODE_RIGHT: direction = RIGHT; break;
+            case SDL_SCANCODE_ESCAPE:
+                m_game_running = false;
+                return t_current;
+            case SDL_SCANCODE_F3:
+                m_perf_overlay = !m_perf_overlay;
+                continue;
+            default: continue;
+        }
 
-    void draw(window_t& t_window)
-    {
-        t_window.clear_screen();
-
-        int i{ 0 };
-        for(auto const& line : m_field) {
-            int j{ 0 };
-            for(auto const cell : line) {
-                switch(cell) {
-                    case cell_type::SNAKE_HEAD: 
-                        t_window.draw(
-                            { i, j }, 
-                            34, 120, 16, 255
-                        );
-                        break;
-                    case cell_type::SNAKE_BODY: 
-                        t_window.draw(
-                            { i, j },
-                            34, 232, 16, 255
-                        );
-                        break;
-                    case cell_type::FRUIT: 
-                        t_window.draw(
-                            { i, j },
-                            244, 13, 45, 255
-                        );
-                        break;
-                    default: break;
-                }  
-                ++j;
-            }
-            ++i;
+        if(direction != t_current && direction != opposite(t_current)) {
+            *t_consumed = press;
+            return direction;
         }
     }
-};
 
-game_field_t::game_field_t() noexcept 
-{
-    for(auto& line : m_field) {
-        line.fill(cell_type::EMPTY);
-    }
+    return t_current;
 }
 
-struct snake_t
+void game_logic_t::game_loop(window_t& t_window, event_t& t_event)
 {
-private:
-    std::list<position_t> m_snake_positions;
-
-    game_field_t& m_field;
-
-    void update_field()
-    {
-        auto it = m_snake_positions.begin();
-
-        m_field((*it).i, (*it).j) = game_field_t::cell_type::SNAKE_HEAD;
-        ++it;
-
-        for(auto snake_cell = it; 
-            snake_cell != m_snake_positions.end(); 
-            ++snake_cell)
-        {
-            m_field((*snake_cell).i, (*snake_cell).j) = 
-                game_field_t::cell_type::SNAKE_BODY;
+    bool const board_texture = m_options.board_texture ||
+        m_options.width > globals::window_size || m_options.height > globals::window_size;
+    t_window.set_board(m_options.height, m_options.width, board_texture);
+    board_texture_t* const board = t_window.board();
+    bool const smooth = m_options.smooth && board == nullptr;
+    view_input_t view_input{};
+    bool view_moved{ false };
+    simulation_t<dynamic_game_field_t> simulation{
+        m_options.seed,
+        dynamic_game_field_t{
+            dynamic_extent_t{ m_options.width, m_options.height }
         }
-    }
+    };
+    dirty_cells_t dirty_cells{};
 
-    void pop_back_snake_body()
-    {
-        position_t pos = m_snake_positions.back();
-        m_field(pos.i, pos.j) = game_field_t::cell_type::EMPTY;
-        m_snake_positions.pop_back();
+    replay_recorder_t recorder{
+        m_options.seed, m_options.width, m_options.height
+    };
+    replay_t const no_replay{};
+    replay_player_t player{ m_replay != nullptr ? *m_replay : no_replay };
+    // Its search buffers are the size of the board, so only made on demand.
+    std::optional<autopilot_t<dynamic_game_field_t>> autopilot{};
+    if(m_options.autopilot) {
+        autopilot.emplace(simulation.get_field());
     }
+    segment_tween_t tween{};
+
+    bool const trace_latency =
+        m_options.latency_overlay || m_options.latency_log != nullptr;
+    latency_trace_t latency{};
+    std::uint64_t tick{ 0 };
+    frame_scheduler_t scheduler{
+        SDL_GetTicks(), globals::max_wait_time_ms, m_options.frame_cap
+    };
 
-    inline bool is_space_for_snake(position_t const& t_pos) {
-        return m_field(t_pos.i, t_pos.j) == game_field_t::cell_type::EMPTY ||
-               m_field(t_pos.i, t_pos.j) == game_field_t::cell_type::FRUIT;
-    }
+    std::size_t shown_length{ 0 };
 
-public:
-    snake_t() = delete; 
-    snake_t(game_field_t& t_field)
-        : m_field{ t_field }
-    {
-        m_snake_positions.emplace_back(
-            game_field_t::height / 2 - 1,
-            game_field_t::width / 2 - 1
+    perf_counters_t perf{};
+    std::uint32_t frames_since_tick{ 0 };
+    bool shown_perf_overlay{ m_perf_overlay };
+    std::int64_t next_perf_update{ 0 };
+
+    while(m_game_running && !t_event.quit()) {
+        std::int64_t const timeout = scheduler.time_until_due(
+            SDL_GetTicks(), !dirty_cells.empty() || tween.active() || view_moved
         );
 
-        this->update_field();
-    }
-    ~snake_t() noexcept = default;
+        t_event.wait_events(static_cast<int>(timeout));
 
-    inline std::size_t get_length() const
-    { return m_snake_positions.size(); }
-    inline position_t get_head_position() const
-    { return m_snake_positions.front(); }
+        std::int64_t const current_time{ SDL_GetTicks() };
 
-    void lengthen_snake_up()
-    {
-        position_t head_pos = m_snake_positions.front();
-        
-        if(head_pos.i <= 0) {
-            throw "Can't move snake up";
+        if(t_event.consume_redraw_request()) {
+            dirty_cells.invalidate();
         }
-        if(!this->is_space_for_snake({ head_pos.i - 1, head_pos.j })) {
-            throw "Can't move snake up";
+        if(board != nullptr && t_event.consume_view_input(view_input)) {
+            board->zoom(std::pow(globals::zoom_step, view_input.wheel),
+                        view_input.x, view_input.y);
+            board->pan(view_input.drag_x, view_input.drag_y);
+            view_moved = true;
         }
 
-        m_snake_positions.emplace_front(
-            head_pos.i - 1, head_pos.j
-        );
+        for(int ticks = scheduler.consume_ticks(current_time);
+            ticks > 0 && m_game_running; --ticks)
+        {
+            SNAKE_TRACE_ZONE("game_loop::tick");
+            auto const tick_start = perf_counters_t::clock::now();
+            std::uint64_t const allocations = allocation_count();
+
+            key_press_t consumed{};
+            direction_type direction = this->next_direction(
+                t_event, simulation.get_direction(), &consumed
+            );
+            ++tick;
+
+            if(autopilot) {
+                direction = autopilot->next_direction(simulation);
+                consumed = key_press_t{};
+            }
+            if(m_replay != nullptr) {
+                if(player.done()) {
+                    m_game_running = false;
+                    break;
+                }
+                direction = player.next();
+                consumed = key_press_t{};
+            }
 
-        this->update_field();
-    }
-    void move_up()
-    {
-        this->lengthen_snake_up();
-        this->pop_back_snake_body();
-    }
-    
-    void lengthen_snake_down()
-    {
-        position_t head_pos = m_snake_positions.front();
-        
-        if(head_pos.i >= game_field_t::height - 1) {
-            throw "Can't move snake down";
-        }
-        if(!this->is_space_for_snake({ head_pos.i + 1, head_pos.j })) {
-            throw "Can't move snake down";
-        }
+            if(trace_latency && consumed.key != SDL_SCANCODE_UNKNOWN) {
+                latency.on_consumed(consumed.timestamp, tick, SDL_GetTicks());
+            }
 
-        m_snake_positions.emplace_front(
-            head_pos.i + 1, head_pos.j
-        );
+            if(m_game_running) {
+                recorder.record(direction);
+                m_game_running = simulation.step(direction);
+                dirty_cells.add(simulation.get_delta());
+
+                if(smooth) {
+                    tween.start(
+                        simulation.get_delta(),
+                        simulation.get_snake().get_tail_position(),
+                        dirty_cells
+                    );
+                }
+            }
 
-        this->update_field();
-    }
-    void move_down()
-    {
-        this->lengthen_snake_down();
-        this->pop_back_snake_body();
-    }
-    
-    void lengthen_snake_left()
-    {
-        position_t head_pos = m_snake_positions.front();
-        
-        if(head_pos.j <= 0) {
-            throw "Can't move snake left";
-        }
-        if(!this->is_space_for_snake({ head_pos.i, head_pos.j - 1 })) {
-            throw "Can't move snake left";
+            perf.add(TICK_US, perf_counters_t::microseconds_since(tick_start));
+            perf.add(ALLOCATIONS_PER_TICK,
+                     static_cast<std::uint32_t>(allocation_count() - allocations));
+            perf.add(FRUITS_PER_TICK, m_game_running && simulation.get_delta().fruit_moved);
+            perf.add(FRAMES_PER_TICK, frames_since_tick);
+            frames_since_tick = 0;
         }
 
-        m_snake_positions.emplace_front(
-            head_pos.i, head_pos.j - 1
-        );
-
-        this->update_field();
-    }
-    void move_left()
-    {
-        this->lengthen_snake_left();
-        this->pop_back_snake_body();
-    }
-    
-    void lengthen_snake_right()
-    {
-        position_t head_pos = m_snake_positions.front();
-        
-        if(head_pos.j >= game_field_t::width - 1) {
-            throw "Can't move snake right";
+        if(!m_game_running) {
+            tween.stop(dirty_cells);
         }
-        if(!this->is_space_for_snake({ head_pos.i, head_pos.j + 1})) {
-            throw "Can't move snake right";
+
+        if(simulation.get_length() != shown_length) {
+            shown_length = simulation.get_length();
+            this->show_score(t_window, shown_length);
         }
 
-        m_snake_positions.emplace_front(
-            head_pos.i, head_pos.j + 1
-        );
+        bool const frame_pending =
+            !dirty_cells.empty() || tween.active() || view_moved;
 
-        this->update_field();
-    }
-    void move_right()
-    {
-        this->lengthen_snake_right();
-        this->pop_back_snake_body();
-    }
-};
+        if(shown_perf_overlay != m_perf_overlay ||
+           (m_perf_overlay && current_time >= next_perf_update)) {
+            this->show_perf(t_window, perf);
+            shown_perf_overlay = m_perf_overlay;
+            next_perf_update = current_time + globals::perf_overlay_period_ms;
+        }
 
-struct fruit_t
-{
-private:
-    position_t m_position;
+        if(frame_pending && scheduler.consume_frame(current_time)) {
+            SNAKE_TRACE_ZONE("game_loop::frame");
+            auto const draw_start = perf_counters_t::clock::now();
 
-    game_field_t& m_field;
+            if(!t_window.keeps_contents()) {
+                dirty_cells.invalidate();
+            }
+            if(board != nullptr) {
+                dirty_cells.redraw(simulation.get_field(), *board);
+            }
+            else {
+                dirty_cells.redraw(simulation.get_field(), t_window);
+            }
+            view_moved = false;
 
-    position_t gen_new_position()
-    {
-        std::mt19937 rng;
-        rng.seed(std::random_device{}());
-        std::uniform_int_distribution<int> dist{ 0, game_field_t::height - 1 };
+            if(tween.active()) {
+                t_window.flush();
+                tween.draw(t_window, scheduler.interpolation(SDL_GetTicks()));
+            }
+            t_window.flush();
 
-        position_t pos{ dist(rng), dist(rng) };
+            auto const present_start = perf_counters_t::clock::now();
+            perf.add(DRAW_US, perf_counters_t::microseconds_since(draw_start));
+            t_window.update();
+            perf.add(PRESENT_US, perf_counters_t::microseconds_since(present_start));
+            ++frames_since_tick;
 
-        while(m_field(pos.i, pos.j) != game_field_t::cell_type::EMPTY) {
-            pos.i = dist(rng);
-            pos.j = dist(rng);
+            if(trace_latency && latency.on_presented(SDL_GetTicks()) &&
+               m_options.latency_overlay) {
+                this->show_latency(t_window, latency);
+            }
         }
+    }
 
-        return pos;
+    if(m_options.latency_log != nullptr &&
+       !latency.dump(m_options.latency_log)) {
+        std::cerr << "Can't write " << m_options.latency_log << std::endl;
     }
 
-    void update_field()
-    { m_field(m_position.i, m_position.j) = game_field_t::cell_type::FRUIT; }
+    if(m_options.perf_log != nullptr) {
+        std::size_t const length = std::strlen(m_options.perf_log);
+        bool const json = length >= 5 &&
+            std::strcmp(m_options.perf_log + length - 5, ".json") == 0;
 
-public:
-    fruit_t() noexcept = delete;
-    fruit_t(game_field_t& t_field)
-        : m_field(t_field)
-    { 
-        m_position = this->gen_new_position(); 
-        this->update_field();
+        if(!(json ? perf.write_json(m_options.perf_log)
+                  : perf.write_csv(m_options.perf_log))) {
+            std::cerr << "Can't write " << m_options.perf_log << std::endl;
+        }
     }
-    ~fruit_t() noexcept = default;
 
-    void new_position()
-    {
-        //position_t prev_pos = m_position;
-        m_position = this->gen_new_position();
-        this->update_field();
-        //m_field(prev_pos.i, prev_pos.j) = game_field_t::cell_type::EMPTY;
+    if(m_options.trace_path != nullptr && !trace_write_chrome(m_options.trace_path)) {
+        std::cerr << "Can't write " << m_options.trace_path
+                  << " (trace zones need -DSNAKE_TRACE=CHROME)" << std::endl;
     }
 
-    position_t get_position() const
-    { return m_position; }
-};
+    if(m_options.record_path != nullptr &&
+       !recorder.get_replay().save(m_options.record_path)) {
+        std::cerr << "Can't write " << m_options.record_path << std::endl;
+    }
 
-struct game_logic_t
-{
-private:
-    bool m_game_running{ true };
-    int m_score{ 0 };
+    m_score = simulation.get_length();
+}
 
-    enum direction_type
+namespace {
+    // Shows the score over the last board and waits for Enter or Y (true) or
+    // Escape, N or the window closing (false).
+    bool ask_play_again(window_t& t_window, event_t& t_event, int const t_score)
     {
-        UP = 0,
-        DOWN,
-        LEFT, 
-        RIGHT
-    };
+        static std::size_t constexpr first_line{ window_t::overlay_lines - 2 };
+        char text[window_t::overlay_line_length];
 
-    direction_type m_direction{ UP };
+        std::snprintf(text, sizeof(text), "GAME OVER - SCORE %d", t_score);
+        t_window.set_overlay_line(first_line, text);
+        t_window.set_overlay_line(first_line + 1, "ENTER: PLAY AGAIN   ESC: QUIT");
+        t_window.update();
+        t_event.clear_key_presses();
 
-    bool is_fruit_in_direction(game_field_t& t_field,
-                               snake_t& t_snake)
-    {
-        position_t pos = t_snake.get_head_position();
-
-        switch(m_direction) {
-            case UP: --pos.i; break;
-            case DOWN: ++pos.i; break;
-            case LEFT: --pos.j; break;
-            case RIGHT: ++pos.j; break;
-            default: break;
-        }
+        int answer{ -1 };
+        while(answer < 0 && !t_event.quit()) {
+            t_event.wait_events(static_cast<int>(globals::max_wait_time_ms));
 
-        return t_field(pos.i, pos.j) == game_field_t::cell_type::FRUIT;
-    }
+            if(t_event.consume_redraw_request()) {
+                t_window.update();
+            }
 
-    void handle_movement(game_field_t& t_field, snake_t& t_snake, 
-            fruit_t& t_fruit)
-    {
-        switch(m_direction) {
-            case UP:
-                if(this->is_fruit_in_direction(t_field, t_snake)) {
-                    try {
-                        t_snake.lengthen_snake_up();
-                        t_fruit.new_position();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                else {
-                    try {
-                        t_snake.move_up();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                break;
-            case DOWN:
-                if(this->is_fruit_in_direction(t_field, t_snake)) {
-                    try {
-                        t_snake.lengthen_snake_down();
-                        t_fruit.new_position();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                else {
-                    try {
-                        t_snake.move_down();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                break;
-            case LEFT:
-                if(this->is_fruit_in_direction(t_field, t_snake)) {
-                    try {
-                        t_snake.lengthen_snake_left();
-                        t_fruit.new_position();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                else {
-                    try {
-                        t_snake.move_left();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                break;
-            case RIGHT:
-                if(this->is_fruit_in_direction(t_field, t_snake)) {
-                    try {
-                        t_snake.lengthen_snake_right();
-                        t_fruit.new_position();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
-                }
-                else {
-                    try {
-                        t_snake.move_right();
-                    }
-                    catch(...) {
-                        m_game_running = false;
-                    }
+            key_press_t press{};
+            while(answer < 0 && t_event.pop_key_press(press)) {
+                switch(press.key) {
+                    case SDL_SCANCODE_RETURN:
+                    case SDL_SCANCODE_Y:
+                        answer = 1;
+                        break;
+                    case SDL_SCANCODE_ESCAPE:
+                    case SDL_SCANCODE_N:
+                        answer = 0;
+                        break;
+                    default: break;
                 }
-                break;
-            default: break;
+            }
         }
-    }
 
-public:
-    game_logic_t() noexcept = default;
-    ~game_logic_t() noexcept = default;
-
-    void game_loop();
-
-    constexpr int get_score() const
-    { return m_score; }
-};
+        t_window.set_overlay_line(first_line, "");
+        t_window.set_overlay_line(first_line + 1, "");
+        return answer == 1;
+    }
+}
 
-void game_logic_t::game_loop()
+int main(int argc, char** argv)
 {
-    window_t window{ 900, 900 };
-    game_field_t field{};
-    snake_t snake{ field };
-    fruit_t fruit{ field };
-    event_t event{};
-
-    std::int64_t last_time{ SDL_GetTicks() };
-    std::int64_t waited_time{ 0 };
-
-    while(m_game_running && !event.quit()) {
-        std::int64_t current_time{ SDL_GetTicks() };
-        std::int64_t elapsed_time = current_time - last_time;
-        last_time = current_time;
-        waited_time += elapsed_time;
-
-        window.set_title(
-            std::string{ "Snake Game! Score: " } + 
-            std::to_string(snake.get_length())
-        );
-
-        field.draw(window);
-        window.update();
-        
-        event.poll_events();
+    game_options_t options{ game_options_t::parse(argc, argv) };
 
-        if(waited_time >= globals::max_wait_time_ms) {
-            switch(event.get_key()) {
-                case SDL_SCANCODE_UP:
-                    if(m_direction == DOWN) break;
-                    m_direction = UP;
-                    break;
-                case SDL_SCANCODE_LEFT:
-                    if(m_direction == RIGHT) break;
-                    m_direction = LEFT; 
-                    break;
-                case SDL_SCANCODE_DOWN: 
-                    if(m_direction == UP) break;
-                    m_direction = DOWN;
-                    break;
-                case SDL_SCANCODE_RIGHT: 
-                    if(m_direction == LEFT) break;
-                    m_direction = RIGHT;
-                    break;
-                case SDL_SCANCODE_ESCAPE: 
-                    m_game_running = false; 
-                    break;
-                default: break;
-            } 
-
-            this->handle_movement(field, snake, fruit);
-            waited_time = 0;
+    replay_t recording{};
+    if(options.replay_path != nullptr) {
+        if(!replay_t::load(options.replay_path, recording)) {
+            std::cerr << "Can't read replay " << options.replay_path << std::endl;
+            return 1;
         }
     }
 
-    m_score = snake.get_length();
-}
+    window_t window{ globals::window_size, globals::window_size, options.vsync };
+    event_t event{};
 
-int main()
-{
-    bool volatile replay{ true };
+    for(bool replay = true; replay; ) {
+        if(options.replay_path != nullptr) {
+            options.seed = recording.seed;
+            options.width = recording.width;
+            options.height = recording.height;
+        }
 
-    while(replay) {
-        game_logic_t game;
-        game.game_loop();
+        game_logic_t game{
+            options, options.replay_path != nullptr ? &recording : nullptr
+        };
+        game.game_loop(window, event);
         
         std::cout << "Score: " << game.get_score() << std::endl;
-        std::cout << "Replay? [y/n]" << std::endl;
+        std::cout << "Seed: " << options.seed << std::endl;
+        ++options.seed;
 
-        char ch;
-        std::cin >> ch;
-        if(ch == 'y' || ch == 'Y') {
-            replay = true;
-        }
-        else {
-            replay = false;
-        }
+        replay = ask_play_again(window, event, game.get_score());
     }
 }
-
-
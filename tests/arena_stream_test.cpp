@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/arena.hpp"
+#include "core/arena_stream.hpp"
+
+#include "test.hpp"
+
+namespace {
+    arena_options_t stream_arena()
+    {
+        arena_options_t options{};
+        options.width = 40;
+        options.height = 30;
+        options.snakes = 60;
+        options.fruits = 25;
+        options.tile_size = 8;
+        options.seed = 3;
+        return options;
+    }
+
+    void fill_directions(std::vector<direction_type>& t_directions, unsigned& t_state)
+    {
+        for(direction_type& direction : t_directions) {
+            t_state = t_state * 1103515245u + 12345u;
+            if((t_state >> 16) % 4 == 0) {
+                direction = static_cast<direction_type>((t_state >> 20) % 4);
+            }
+        }
+    }
+
+    // Applies the single frame held in t_frame.
+    bool apply_frame(arena_view_t& t_view, std::vector<std::uint8_t> const& t_frame)
+    {
+        std::size_t payload{ 0 };
+        return peek_arena_frame(t_frame.data(), t_frame.size(), payload) &&
+               arena_frame_header_size + payload == t_frame.size() &&
+               t_view.apply(t_frame.data() + arena_frame_header_size, payload);
+    }
+
+    bool same_board(arena_view_t const& t_view, arena_simulation_t const& t_arena)
+    {
+        auto const& field = t_arena.get_field();
+        if(t_view.width() != field.width() || t_view.height() != field.height() ||
+           t_view.size() != t_arena.size()) {
+            return false;
+        }
+
+        arena_checksum_t checksum{};
+        for(int i = 0; i < field.height(); ++i) {
+            for(int j = 0; j < field.width(); ++j) {
+                if(t_view.cells()[i * field.width() + j] != field(i, j)) {
+                    return false;
+                }
+                checksum.add(field(i, j));
+            }
+        }
+        for(std::size_t snake = 0; snake < t_arena.size(); ++snake) {
+            if(t_view.is_alive(snake) != t_arena.is_alive(snake) ||
+               (t_arena.is_alive(snake) && t_view.get_length(snake) != t_arena.get_length(snake))) {
+                return false;
+            }
+        }
+        return t_view.checksum() == checksum.value;
+    }
+}
+
+// A spectator joining mid-game, fed a snapshot and then only tick deltas,
+// must keep an exact copy of the board and of every body.
+SNAKE_TEST(arena_stream_deltas_rebuild_the_arena)
+{
+    arena_options_t const options = stream_arena();
+    arena_simulation_t arena{ options };
+    std::vector<direction_type> directions(options.snakes, RIGHT);
+    unsigned state{ 13 };
+
+    arena_view_t view{};
+    std::vector<std::uint8_t> frame;
+
+    for(std::uint64_t tick = 1; tick <= 400; ++tick) {
+        fill_directions(directions, state);
+        arena.step(directions.data());
+
+        frame.clear();
+        if(tick == 40) {
+            encode_arena_snapshot(arena, tick, frame);
+        }
+        else {
+            encode_arena_tick(arena, tick, tick % 16 == 0, frame);
+        }
+
+        if(tick < 40) {
+            // Not joined yet; tick frames alone can't sync a view.
+            SNAKE_CHECK(!view.synced());
+            continue;
+        }
+
+        SNAKE_CHECK(apply_frame(view, frame));
+        SNAKE_CHECK(view.synced());
+        SNAKE_CHECK(view.tick() == tick);
+        SNAKE_CHECK(same_board(view, arena));
+    }
+}
+
+SNAKE_TEST(arena_stream_detects_a_bad_checksum_or_a_missed_tick)
+{
+    arena_options_t const options = stream_arena();
+    arena_simulation_t arena{ options };
+    std::vector<direction_type> directions(options.snakes, DOWN);
+    unsigned state{ 7 };
+
+    std::vector<std::uint8_t> snapshot;
+    encode_arena_snapshot(arena, 0, snapshot);
+
+    fill_directions(directions, state);
+    arena.step(directions.data());
+    std::vector<std::uint8_t> first;
+    encode_arena_tick(arena, 1, true, first);
+
+    fill_directions(directions, state);
+    arena.step(directions.data());
+    std::vector<std::uint8_t> second;
+    encode_arena_tick(arena, 2, true, second);
+
+    // The checksum is the frame's last varint; change its first byte's
+    // low bits, keeping the continuation bit.
+    arena_view_t view{};
+    SNAKE_CHECK(apply_frame(view, snapshot));
+    std::vector<std::uint8_t> corrupt = first;
+    std::size_t at = corrupt.size();
+    while(at > arena_frame_header_size + 1 && (corrupt[at - 2] & 0x80) != 0) {
+        --at;
+    }
+    corrupt[at - 1] ^= 0x01;
+    SNAKE_CHECK(!apply_frame(view, corrupt));
+    SNAKE_CHECK(!view.synced());
+    // Out of sync, good frames are refused too until a snapshot comes.
+    SNAKE_CHECK(!apply_frame(view, second));
+
+    SNAKE_CHECK(apply_frame(view, snapshot));
+    SNAKE_CHECK(!apply_frame(view, second));
+    SNAKE_CHECK(!view.synced());
+
+    SNAKE_CHECK(apply_frame(view, snapshot));
+    SNAKE_CHECK(apply_frame(view, first));
+    SNAKE_CHECK(apply_frame(view, second));
+    SNAKE_CHECK(same_board(view, arena));
+}
@@ -0,0 +1,131 @@
+#include <cstddef>
+#include <vector>
+
+#include "core/arena.hpp"
+
+#include "test.hpp"
+
+namespace {
+    arena_options_t small_arena()
+    {
+        arena_options_t options{};
+        options.width = 64;
+        options.height = 48;
+        options.snakes = 200;
+        options.fruits = 40;
+        // Many small tiles, so snakes often fight over a tile's border.
+        options.tile_size = 8;
+        options.seed = 17;
+        return options;
+    }
+
+    void fill_directions(std::vector<direction_type>& t_directions, unsigned& t_state)
+    {
+        for(direction_type& direction : t_directions) {
+            t_state = t_state * 1103515245u + 12345u;
+            // Mostly keep going so snakes live long enough to collide.
+            if((t_state >> 16) % 4 == 0) {
+                direction = static_cast<direction_type>((t_state >> 20) % 4);
+            }
+        }
+    }
+
+    bool same_arena(arena_simulation_t const& t_a, arena_simulation_t const& t_b)
+    {
+        if(t_a.alive_count() != t_b.alive_count()) {
+            return false;
+        }
+        for(std::size_t snake = 0; snake < t_a.size(); ++snake) {
+            if(t_a.is_alive(snake) != t_b.is_alive(snake) ||
+               t_a.get_result(snake) != t_b.get_result(snake) ||
+               t_a.get_length(snake) != t_b.get_length(snake)) {
+                return false;
+            }
+        }
+
+        auto const& a = t_a.get_field();
+        auto const& b = t_b.get_field();
+        for(int i = 0; i < a.height(); ++i) {
+            for(int j = 0; j < a.width(); ++j) {
+                if(a(i, j) != b(i, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// The outcome must depend only on the seed and the directions, never on
+// how plan and resolve were spread over threads.
+SNAKE_TEST(arena_output_does_not_depend_on_the_thread_count)
+{
+    arena_options_t const options = small_arena();
+
+    arena_simulation_t serial{ options };
+    arena_simulation_t one{ options };
+    arena_simulation_t four{ options };
+    thread_pool_t one_thread{ 1 };
+    thread_pool_t four_threads{ 4 };
+
+    std::vector<direction_type> directions(options.snakes, UP);
+    unsigned state{ 29 };
+    std::size_t deaths{ 0 };
+
+    for(int tick = 0; tick < 300; ++tick) {
+        fill_directions(directions, state);
+
+        serial.step(directions.data());
+        one.step(directions.data(), one_thread);
+        four.step(directions.data(), four_threads);
+
+        SNAKE_CHECK(same_arena(one, serial));
+        SNAKE_CHECK(same_arena(four, serial));
+
+        for(std::size_t snake = 0; snake < serial.size(); ++snake) {
+            deaths += serial.get_result(snake) == snake_base_t::COLLIDED;
+        }
+    }
+
+    // Make sure collisions, and so the resolve phase, were exercised.
+    SNAKE_CHECK(deaths > 0);
+}
+
+// Every snake cell on the board belongs to a live snake.
+SNAKE_TEST(arena_board_holds_exactly_the_live_snakes)
+{
+    arena_options_t options = small_arena();
+    options.respawn = false;
+
+    arena_simulation_t arena{ options };
+    std::vector<direction_type> directions(options.snakes, LEFT);
+    unsigned state{ 41 };
+
+    for(int tick = 0; tick < 200; ++tick) {
+        fill_directions(directions, state);
+        arena.step(directions.data());
+
+        std::size_t length{ 0 };
+        std::size_t alive{ 0 };
+        for(std::size_t snake = 0; snake < arena.size(); ++snake) {
+            if(arena.is_alive(snake)) {
+                length += arena.get_length(snake);
+                ++alive;
+            }
+        }
+
+        auto const& field = arena.get_field();
+        std::size_t snake_cells{ 0 };
+        std::size_t heads{ 0 };
+        for(int i = 0; i < field.height(); ++i) {
+            for(int j = 0; j < field.width(); ++j) {
+                snake_cells += field.is_snake(i, j);
+                heads += field(i, j) == field_base_t::SNAKE_HEAD;
+            }
+        }
+
+        SNAKE_CHECK(alive == arena.alive_count());
+        SNAKE_CHECK(snake_cells == length);
+        SNAKE_CHECK(heads == alive);
+    }
+}
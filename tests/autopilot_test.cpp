@@ -0,0 +1,65 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "core/autopilot.hpp"
+#include "core/simulation.hpp"
+
+#include "test.hpp"
+
+namespace {
+    // Plays t_games seeded games on a t_width x t_height board and returns
+    // the lowest and the average share of the board the snake filled.
+    void play(int const t_width, int const t_height, int const t_games,
+              double& t_worst, double& t_average)
+    {
+        dynamic_game_field_t const empty{ dynamic_extent_t{ t_width, t_height } };
+        std::size_t const cells = std::size_t(t_width) * t_height;
+
+        t_worst = 1.0;
+        t_average = 0.0;
+
+        for(int game = 0; game < t_games; ++game) {
+            simulation_t<dynamic_game_field_t> simulation{ std::uint64_t(game + 1), empty };
+            autopilot_t<dynamic_game_field_t> autopilot{ simulation.get_field() };
+
+            // Generous, but stops a game that loops without eating.
+            for(std::size_t tick = 0; tick < 4 * cells * cells && simulation.is_running(); ++tick) {
+                simulation.step(autopilot.next_direction(simulation));
+            }
+
+            double const fill = double(simulation.get_length()) / double(cells);
+            t_worst = fill < t_worst ? fill : t_worst;
+            t_average += fill / t_games;
+        }
+    }
+}
+
+// With an even side the snake follows the Hamiltonian cycle and always
+// fills the board.
+SNAKE_TEST(autopilot_fills_boards_with_a_cycle)
+{
+    double worst{ 0.0 };
+    double average{ 0.0 };
+
+    play(10, 10, 20, worst, average);
+    SNAKE_CHECK(worst == 1.0);
+
+    play(9, 12, 20, worst, average);
+    SNAKE_CHECK(worst == 1.0);
+}
+
+// Odd by odd boards have no Hamiltonian cycle; keeping the tail reachable
+// must still get long games, where greedy paths used to end below half.
+SNAKE_TEST(autopilot_plays_long_games_on_odd_boards)
+{
+    double worst{ 0.0 };
+    double average{ 0.0 };
+
+    play(7, 7, 20, worst, average);
+    SNAKE_CHECK(worst >= 0.5);
+    SNAKE_CHECK(average >= 0.85);
+
+    play(15, 11, 10, worst, average);
+    SNAKE_CHECK(worst >= 0.5);
+    SNAKE_CHECK(average >= 0.85);
+}
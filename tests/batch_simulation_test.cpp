@@ -0,0 +1,153 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/batch_simulation.hpp"
+#include "core/simulation.hpp"
+
+#include "test.hpp"
+
+namespace {
+    int constexpr width{ 13 };
+    int constexpr height{ 7 };
+
+    using batch_type = batch_simulation_t<width, height>;
+    using simulation_type = simulation_t<dynamic_game_field_t>;
+
+    std::unique_ptr<simulation_type> make_simulation(std::uint64_t const t_seed)
+    {
+        return std::make_unique<simulation_type>(
+            t_seed, dynamic_game_field_t{ dynamic_extent_t{ width, height } }
+        );
+    }
+
+    bool same_board(batch_type const& t_batch, std::size_t const t_game,
+                    simulation_type const& t_simulation)
+    {
+        batch_type::cell_type const* cells = t_batch.get_cells(t_game);
+        dynamic_game_field_t const& field = t_simulation.get_field();
+
+        for(int i = 0; i < height; ++i) {
+            for(int j = 0; j < width; ++j) {
+                if(cells[i * width + j] != field(i, j)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void fill_directions(std::vector<direction_type>& t_directions, unsigned& t_state)
+    {
+        for(direction_type& direction : t_directions) {
+            t_state = t_state * 1103515245u + 12345u;
+            direction = static_cast<direction_type>((t_state >> 16) % 4);
+        }
+    }
+}
+
+// Every game of the batch must replay like simulation_t from its seed,
+// including the reseeded episodes that follow a game over.
+SNAKE_TEST(batch_simulation_matches_simulation)
+{
+    std::size_t constexpr count{ 16 };
+    std::uint64_t constexpr base_seed{ 100 };
+
+    batch_type batch{ count, base_seed };
+    std::vector<std::unique_ptr<simulation_type>> simulations;
+    for(std::size_t game = 0; game < count; ++game) {
+        simulations.push_back(make_simulation(base_seed + game));
+    }
+
+    std::vector<direction_type> directions(count);
+    unsigned state{ 3 };
+    int episodes{ 0 };
+
+    for(int tick = 0; tick < 2000; ++tick) {
+        fill_directions(directions, state);
+        batch.step(directions.data());
+
+        for(std::size_t game = 0; game < count; ++game) {
+            bool const running = simulations[game]->step(directions[game]);
+
+            SNAKE_CHECK(batch.get_done(game) == !running);
+            SNAKE_CHECK(batch.get_result(game) == simulations[game]->get_delta().result);
+            if(!running) {
+                ++episodes;
+                simulations[game] = make_simulation(batch.get_seed(game));
+                SNAKE_CHECK(batch.get_seed(game) ==
+                            base_seed + game + batch.get_episode(game) * count);
+            }
+
+            SNAKE_CHECK(batch.get_length(game) == simulations[game]->get_length());
+            position_t const head = simulations[game]->get_snake().get_head_position();
+            SNAKE_CHECK(batch.get_head(game).i == head.i);
+            SNAKE_CHECK(batch.get_head(game).j == head.j);
+            SNAKE_CHECK(same_board(batch, game, *simulations[game]));
+        }
+    }
+
+    // Random play dies often; make sure resets were actually exercised.
+    SNAKE_CHECK(episodes > 0);
+}
+
+SNAKE_TEST(batch_simulation_on_a_pool_matches_one_thread)
+{
+    std::size_t constexpr count{ 1000 };
+
+    batch_type serial{ count, 7 };
+    batch_type pooled{ count, 7 };
+    thread_pool_t pool{ 4 };
+
+    std::vector<direction_type> directions(count);
+    unsigned state{ 11 };
+
+    for(int tick = 0; tick < 200; ++tick) {
+        fill_directions(directions, state);
+        serial.step(directions.data());
+        pooled.step(directions.data(), pool, 16);
+    }
+
+    for(std::size_t game = 0; game < count; ++game) {
+        SNAKE_CHECK(serial.get_episode(game) == pooled.get_episode(game));
+        SNAKE_CHECK(serial.get_length(game) == pooled.get_length(game));
+
+        batch_type::cell_type const* a = serial.get_cells(game);
+        batch_type::cell_type const* b = pooled.get_cells(game);
+        bool same{ true };
+        for(std::size_t index = 0; index < serial.cell_count(); ++index) {
+            same = same && a[index] == b[index];
+        }
+        SNAKE_CHECK(same);
+    }
+}
+
+// Runs on the scalar kernel alone when the CPU lacks AVX2. 37 games leave
+// a partial block of 8 for the vector kernel's scalar tail.
+SNAKE_TEST(batch_simulation_kernels_agree)
+{
+    std::size_t constexpr count{ 37 };
+
+    batch_type scalar{ count, 21 };
+    batch_type vector{ count, 21 };
+    scalar.set_kernel(SCALAR_KERNEL);
+    vector.set_kernel(AVX2_KERNEL);
+    SNAKE_CHECK(scalar.get_kernel() == SCALAR_KERNEL);
+
+    std::vector<direction_type> directions(count);
+    unsigned state{ 5 };
+
+    for(int tick = 0; tick < 2000; ++tick) {
+        fill_directions(directions, state);
+        scalar.step(directions.data());
+        vector.step(directions.data());
+
+        for(std::size_t game = 0; game < count; ++game) {
+            SNAKE_CHECK(scalar.get_result(game) == vector.get_result(game));
+            SNAKE_CHECK(scalar.get_episode(game) == vector.get_episode(game));
+            SNAKE_CHECK(scalar.get_length(game) == vector.get_length(game));
+            SNAKE_CHECK(scalar.get_direction(game) == vector.get_direction(game));
+        }
+    }
+}
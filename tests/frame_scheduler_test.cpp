@@ -0,0 +1,40 @@
+#include "frontend/frame_scheduler.hpp"
+
+#include "test.hpp"
+
+SNAKE_TEST(frame_scheduler_runs_a_fixed_timestep)
+{
+    frame_scheduler_t scheduler{ 1000, 100, 50 };
+
+    SNAKE_CHECK(scheduler.time_until_due(1000, false) == 100);
+    SNAKE_CHECK(scheduler.time_until_due(1060, false) == 40);
+    SNAKE_CHECK(scheduler.consume_ticks(1099) == 0);
+    SNAKE_CHECK(scheduler.consume_ticks(1100) == 1);
+
+    // A late frame catches up, and the remainder carries over.
+    SNAKE_CHECK(scheduler.consume_ticks(1350) == 2);
+    SNAKE_CHECK(scheduler.interpolation(1350) == 0.5);
+    SNAKE_CHECK(scheduler.time_until_due(1350, false) == 50);
+}
+
+SNAKE_TEST(frame_scheduler_drops_ticks_past_the_catch_up_limit)
+{
+    frame_scheduler_t scheduler{ 1000, 100, 50 };
+
+    SNAKE_CHECK(scheduler.consume_ticks(3050) == 5);
+    // The tick phase is kept: the next one is still on a multiple of 100.
+    SNAKE_CHECK(scheduler.time_until_due(3050, false) == 50);
+    SNAKE_CHECK(scheduler.consume_ticks(3100) == 1);
+}
+
+SNAKE_TEST(frame_scheduler_caps_presents)
+{
+    frame_scheduler_t scheduler{ 1000, 100, 50 };
+
+    // The first frame is due at once, the next one 20 ms later.
+    SNAKE_CHECK(scheduler.time_until_due(1000, true) == 0);
+    SNAKE_CHECK(scheduler.consume_frame(1000));
+    SNAKE_CHECK(scheduler.time_until_due(1005, true) == 15);
+    SNAKE_CHECK(!scheduler.consume_frame(1019));
+    SNAKE_CHECK(scheduler.consume_frame(1020));
+}
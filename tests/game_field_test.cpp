@@ -0,0 +1,212 @@
+#include <cstddef>
+#include <vector>
+
+#include "core/game_field.hpp"
+
+#include "test.hpp"
+
+namespace {
+    // The free-cell index must list every EMPTY cell exactly once.
+    template<typename Field>
+    bool index_matches_board(Field const& t_field)
+    {
+        std::vector<int> seen(std::size_t(t_field.width()) * t_field.height(), 0);
+        std::size_t empty{ 0 };
+
+        for(std::size_t k = 0; k < t_field.free_cell_count(); ++k) {
+            position_t const cell = t_field.free_cell(k);
+            if(t_field(cell.i, cell.j) != field_base_t::EMPTY) {
+                return false;
+            }
+            ++seen[cell.i * t_field.width() + cell.j];
+        }
+        for(int i = 0; i < t_field.height(); ++i) {
+            for(int j = 0; j < t_field.width(); ++j) {
+                bool const is_empty = t_field(i, j) == field_base_t::EMPTY;
+                empty += is_empty ? 1 : 0;
+                if(seen[i * t_field.width() + j] != (is_empty ? 1 : 0)) {
+                    return false;
+                }
+            }
+        }
+        return empty == t_field.free_cell_count();
+    }
+
+    template<typename Field>
+    void check_free_cell_index(Field t_field)
+    {
+        unsigned state{ 99 };
+
+        SNAKE_CHECK(t_field.free_cell_count() == std::size_t(t_field.width()) * t_field.height());
+        SNAKE_CHECK(index_matches_board(t_field));
+
+        for(int k = 0; k < 2000; ++k) {
+            state = state * 1103515245u + 12345u;
+            int const i = static_cast<int>((state >> 8) % t_field.height());
+            int const j = static_cast<int>((state >> 16) % t_field.width());
+            auto const cell = static_cast<field_base_t::cell_type>((state >> 24) % 4);
+
+            t_field.set(i, j, cell);
+            SNAKE_CHECK(index_matches_board(t_field));
+        }
+
+        for(int i = 0; i < t_field.height(); ++i) {
+            for(int j = 0; j < t_field.width(); ++j) {
+                t_field.set(i, j, field_base_t::SNAKE_BODY);
+            }
+        }
+        SNAKE_CHECK(t_field.free_cell_count() == 0);
+    }
+
+    // Undoing sets newest first must give back the same cells and the same
+    // free-cell order, since fruit draws index into that order.
+    template<typename Field>
+    void check_revert(Field t_field)
+    {
+        struct change_t
+        {
+            int i;
+            int j;
+            field_base_t::cell_type previous;
+            int slot;
+        };
+
+        unsigned state{ 31 };
+        std::vector<change_t> changes;
+
+        for(int k = 0; k < 300; ++k) {
+            state = state * 1103515245u + 12345u;
+            t_field.set(static_cast<int>((state >> 8) % t_field.height()),
+                        static_cast<int>((state >> 16) % t_field.width()),
+                        static_cast<field_base_t::cell_type>((state >> 24) % 4));
+        }
+        Field const original = t_field;
+
+        for(int k = 0; k < 2000; ++k) {
+            state = state * 1103515245u + 12345u;
+            int const i = static_cast<int>((state >> 8) % t_field.height());
+            int const j = static_cast<int>((state >> 16) % t_field.width());
+
+            changes.push_back({ i, j, t_field(i, j), t_field.free_slot(i, j) });
+            t_field.set(i, j, static_cast<field_base_t::cell_type>((state >> 24) % 4));
+        }
+
+        for(auto change = changes.rbegin(); change != changes.rend(); ++change) {
+            t_field.revert(change->i, change->j, change->previous, change->slot);
+        }
+
+        bool same_cells{ true };
+        for(int i = 0; i < t_field.height(); ++i) {
+            for(int j = 0; j < t_field.width(); ++j) {
+                same_cells = same_cells && t_field(i, j) == original(i, j);
+            }
+        }
+        SNAKE_CHECK(same_cells);
+
+        SNAKE_CHECK(t_field.free_cell_count() == original.free_cell_count());
+        bool same_order{ t_field.free_cell_count() == original.free_cell_count() };
+        for(std::size_t k = 0; same_order && k < t_field.free_cell_count(); ++k) {
+            same_order = t_field.free_cell(k).i == original.free_cell(k).i &&
+                         t_field.free_cell(k).j == original.free_cell(k).j;
+        }
+        SNAKE_CHECK(same_order);
+        SNAKE_CHECK(index_matches_board(t_field));
+    }
+}
+
+SNAKE_TEST(free_cell_index_follows_every_set)
+{
+    check_free_cell_index(default_game_field_t{});
+    check_free_cell_index(dynamic_game_field_t{ dynamic_extent_t{ 13, 7 } });
+    check_free_cell_index(packed_game_field_t{ dynamic_extent_t{ 13, 7 } });
+}
+
+SNAKE_TEST(free_cell_index_reverts_to_the_same_order)
+{
+    check_revert(default_game_field_t{});
+    check_revert(dynamic_game_field_t{ dynamic_extent_t{ 13, 7 } });
+    check_revert(packed_game_field_t{ dynamic_extent_t{ 13, 7 } });
+}
+
+// Four bits per cell, sixteen cells to a word: neighbours must never
+// bleed into each other.
+SNAKE_TEST(packed_cells_read_back_like_bytes)
+{
+    dynamic_game_field_t bytes{ dynamic_extent_t{ 17, 9 } };
+    packed_game_field_t packed{ dynamic_extent_t{ 17, 9 } };
+    unsigned state{ 31 };
+
+    for(int k = 0; k < 3000; ++k) {
+        state = state * 1103515245u + 12345u;
+        int const i = static_cast<int>((state >> 8) % 9);
+        int const j = static_cast<int>((state >> 16) % 17);
+        auto const cell = static_cast<field_base_t::cell_type>((state >> 24) % 4);
+
+        bytes.set(i, j, cell);
+        packed.set(i, j, cell);
+    }
+
+    for(int i = 0; i < 9; ++i) {
+        for(int j = 0; j < 17; ++j) {
+            SNAKE_CHECK(packed(i, j) == bytes(i, j));
+            SNAKE_CHECK(packed.is_snake(i, j) == bytes.is_snake(i, j));
+            SNAKE_CHECK(bytes.is_snake(i, j) == (bytes(i, j) == field_base_t::SNAKE_HEAD ||
+                                                 bytes(i, j) == field_base_t::SNAKE_BODY));
+        }
+    }
+    SNAKE_CHECK(packed.free_cell_count() == bytes.free_cell_count());
+}
+
+SNAKE_TEST(field_at_is_error_off_the_board)
+{
+    dynamic_game_field_t const field{ dynamic_extent_t{ 13, 7 } };
+
+    SNAKE_CHECK(field.at(0, 12) == field_base_t::EMPTY);
+    SNAKE_CHECK(field.at(6, 0) == field_base_t::EMPTY);
+    SNAKE_CHECK(field.at(-1, 0) == field_base_t::ERROR);
+    SNAKE_CHECK(field.at(0, 13) == field_base_t::ERROR);
+    SNAKE_CHECK(field.at(7, 0) == field_base_t::ERROR);
+}
+
+namespace {
+    struct recording_window_t
+    {
+        int clears{ 0 };
+        std::vector<int> drawn;
+        std::vector<field_base_t::cell_type> cells;
+        int width{ 0 };
+
+        void clear_screen()
+        { ++clears; }
+        void draw(position_t const& t_pos, field_base_t::cell_type const t_cell)
+        {
+            ++drawn[t_pos.i * width + t_pos.j];
+            cells[t_pos.i * width + t_pos.j] = t_cell;
+        }
+    };
+}
+
+// draw() hands the window every non-empty cell once, with its type, and
+// leaves grouping by colour to the window.
+SNAKE_TEST(field_draw_visits_each_non_empty_cell_once)
+{
+    dynamic_game_field_t field{ dynamic_extent_t{ 11, 6 } };
+    field.set(0, 0, field_base_t::SNAKE_HEAD);
+    field.set(0, 1, field_base_t::SNAKE_BODY);
+    field.set(5, 10, field_base_t::FRUIT);
+
+    recording_window_t window{};
+    window.width = field.width();
+    window.drawn.assign(std::size_t(field.width()) * field.height(), 0);
+    window.cells.assign(window.drawn.size(), field_base_t::EMPTY);
+    field.draw(window);
+
+    SNAKE_CHECK(window.clears == 1);
+    for(int i = 0; i < field.height(); ++i) {
+        for(int j = 0; j < field.width(); ++j) {
+            bool const filled = field(i, j) != field_base_t::EMPTY;
+            SNAKE_CHECK(window.drawn[i * field.width() + j] == (filled ? 1 : 0));
+            SNAKE_CHECK(window.cells[i * field.width() + j] == field(i, j));
+        }
+    }
+}
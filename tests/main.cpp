@@ -0,0 +1,42 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "test.hpp"
+
+std::vector<test_case_t>& test_registry()
+{
+    static std::vector<test_case_t> registry;
+    return registry;
+}
+
+int& test_failures()
+{
+    static int failures{ 0 };
+    return failures;
+}
+
+// snake_tests [<filter>]: runs every test, or those whose name contains
+// <filter>.
+int main(int argc, char** argv)
+{
+    char const* filter = argc > 1 ? argv[1] : "";
+    int failed_tests{ 0 };
+    int run{ 0 };
+
+    for(test_case_t const& test : test_registry()) {
+        if(std::strstr(test.name, filter) == nullptr) {
+            continue;
+        }
+
+        int const before = test_failures();
+        test.run();
+        ++run;
+
+        bool const passed = test_failures() == before;
+        failed_tests += passed ? 0 : 1;
+        std::printf("[%s] %s\n", passed ? " OK " : "FAIL", test.name);
+    }
+
+    std::printf("%d of %d tests passed\n", run - failed_tests, run);
+    return failed_tests == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
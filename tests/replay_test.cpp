@@ -0,0 +1,141 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/replay.hpp"
+#include "core/simulation.hpp"
+
+#include "test.hpp"
+
+namespace {
+    replay_t sample_replay(std::uint64_t const t_seed)
+    {
+        replay_t replay{};
+        replay.seed = t_seed;
+        replay.width = 300;
+        replay.height = 2;
+        // A change's tick delta shares its varint with the direction, so
+        // it has two bits less room.
+        std::uint64_t const last = 129 + (t_seed >> 2);
+        replay.tick_count = last + 1;
+        replay.changes = { { 0, LEFT }, { 1, DOWN }, { 129, RIGHT }, { last, UP } };
+        return replay;
+    }
+
+}
+
+// Seeds and ticks on either side of each varint byte boundary.
+SNAKE_TEST(replay_round_trips_through_varints)
+{
+    std::uint64_t const seeds[]{
+        0, 127, 128, 16383, 16384, std::uint64_t{ 1 } << 35,
+        std::uint64_t{ 1 } << 63, ~std::uint64_t{ 0 }
+    };
+
+    for(std::uint64_t const seed : seeds) {
+        replay_t const original = sample_replay(seed);
+
+        std::vector<std::uint8_t> bytes{ 0xAB };
+        original.encode(bytes);
+        // Trailing bytes are left for the caller.
+        bytes.push_back(0xCD);
+
+        replay_t decoded{};
+        std::size_t const read = replay_t::decode(bytes.data() + 1, bytes.size() - 1, decoded);
+
+        SNAKE_CHECK(read == bytes.size() - 2);
+        SNAKE_CHECK(decoded.seed == original.seed);
+        SNAKE_CHECK(decoded.width == original.width);
+        SNAKE_CHECK(decoded.height == original.height);
+        SNAKE_CHECK(decoded.tick_count == original.tick_count);
+        SNAKE_CHECK(decoded.changes.size() == original.changes.size());
+        for(std::size_t k = 0; k < decoded.changes.size() && k < original.changes.size(); ++k) {
+            SNAKE_CHECK(decoded.changes[k].tick == original.changes[k].tick);
+            SNAKE_CHECK(decoded.changes[k].direction == original.changes[k].direction);
+        }
+    }
+}
+
+SNAKE_TEST(replay_rejects_truncated_and_corrupt_input)
+{
+    replay_t const original = sample_replay(5);
+    std::vector<std::uint8_t> bytes;
+    original.encode(bytes);
+
+    replay_t decoded{};
+    for(std::size_t size = 0; size < bytes.size(); ++size) {
+        SNAKE_CHECK(replay_t::decode(bytes.data(), size, decoded) == 0);
+    }
+
+    std::vector<std::uint8_t> corrupt = bytes;
+    corrupt[0] = 'X';
+    SNAKE_CHECK(replay_t::decode(corrupt.data(), corrupt.size(), decoded) == 0);
+
+    corrupt = bytes;
+    corrupt[4] = replay_t::version + 1;
+    SNAKE_CHECK(replay_t::decode(corrupt.data(), corrupt.size(), decoded) == 0);
+
+    // Boards too small, too long on one side, or with too many cells.
+    struct board_t { int width; int height; };
+    board_t const rejected[]{
+        { 1, 300 }, { 300, 1 }, { replay_t::max_side + 1, 2 }, { 4097, 4096 }
+    };
+    for(board_t const& board : rejected) {
+        replay_t bad = original;
+        bad.width = board.width;
+        bad.height = board.height;
+
+        std::vector<std::uint8_t> encoded;
+        bad.encode(encoded);
+        SNAKE_CHECK(replay_t::decode(encoded.data(), encoded.size(), decoded) == 0);
+    }
+
+    replay_t huge = original;
+    huge.width = 4096;
+    huge.height = 4096;
+    std::vector<std::uint8_t> largest;
+    huge.encode(largest);
+    SNAKE_CHECK(replay_t::decode(largest.data(), largest.size(), decoded) == largest.size());
+}
+
+// Recording a game and playing the directions back must end it the same.
+SNAKE_TEST(replay_player_reproduces_the_recorded_game)
+{
+    unsigned state{ 9 };
+    simulation_t<dynamic_game_field_t> recorded{
+        77, dynamic_game_field_t{ dynamic_extent_t{ 12, 8 } }
+    };
+    replay_recorder_t recorder{ 77, 12, 8 };
+
+    while(recorded.is_running()) {
+        state = state * 1103515245u + 12345u;
+        // Mostly keep going straight so the game lasts a while.
+        direction_type direction = recorded.get_direction();
+        if((state >> 16) % 4 == 0) {
+            direction = static_cast<direction_type>((state >> 20) % 4);
+        }
+        recorder.record(direction);
+        recorded.step(direction);
+    }
+
+    std::vector<std::uint8_t> bytes;
+    recorder.get_replay().encode(bytes);
+    replay_t replay{};
+    SNAKE_CHECK(replay_t::decode(bytes.data(), bytes.size(), replay) == bytes.size());
+
+    simulation_t<dynamic_game_field_t> replayed{
+        replay.seed,
+        dynamic_game_field_t{ dynamic_extent_t{ replay.width, replay.height } }
+    };
+    replay_player_t player{ replay };
+    while(!player.done()) {
+        replayed.step(player.next());
+    }
+
+    SNAKE_CHECK(!replayed.is_running());
+    SNAKE_CHECK(replayed.get_length() == recorded.get_length());
+    SNAKE_CHECK(replayed.get_snake().get_head_position().i ==
+                recorded.get_snake().get_head_position().i);
+    SNAKE_CHECK(replayed.get_snake().get_head_position().j ==
+                recorded.get_snake().get_head_position().j);
+}
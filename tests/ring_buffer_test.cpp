@@ -0,0 +1,61 @@
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "core/ring_buffer.hpp"
+
+#include "test.hpp"
+
+SNAKE_TEST(ring_buffer_wraps_around_at_the_front)
+{
+    ring_buffer_t<std::array<int, 4>> buffer{};
+
+    for(int k = 0; k < 4; ++k) {
+        buffer.push_front(k);
+    }
+    SNAKE_CHECK(buffer.full());
+    SNAKE_CHECK(buffer.front() == 3);
+    SNAKE_CHECK(buffer.back() == 0);
+
+    buffer.pop_back();
+    buffer.push_front(4);
+    SNAKE_CHECK(buffer.full());
+    for(std::size_t k = 0; k < buffer.size(); ++k) {
+        SNAKE_CHECK(buffer[k] == 4 - static_cast<int>(k));
+    }
+
+    buffer.clear();
+    SNAKE_CHECK(buffer.empty());
+}
+
+// A snake-like mix of pushes and pops, kept in step with a std::deque.
+SNAKE_TEST(ring_buffer_matches_a_deque)
+{
+    ring_buffer_t<std::vector<int>> buffer{ std::vector<int>(7) };
+    std::deque<int> expected;
+    unsigned state{ 12345 };
+
+    for(int k = 0; k < 1000; ++k) {
+        state = state * 1103515245u + 12345u;
+        unsigned const choice = (state >> 16) % 4;
+
+        if(choice == 0 && !expected.empty()) {
+            buffer.pop_back();
+            expected.pop_back();
+        }
+        else if(choice == 1 && !buffer.full()) {
+            buffer.push_back(k);
+            expected.push_back(k);
+        }
+        else if(!buffer.full()) {
+            buffer.push_front(k);
+            expected.push_front(k);
+        }
+
+        SNAKE_CHECK(buffer.size() == expected.size());
+        for(std::size_t index = 0; index < expected.size(); ++index) {
+            SNAKE_CHECK(buffer[index] == expected[index]);
+        }
+    }
+}
@@ -0,0 +1,252 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/simulation.hpp"
+
+#include "test.hpp"
+
+namespace {
+    using simulation_type = simulation_t<default_game_field_t>;
+
+    template<typename Field>
+    int count_cells(Field const& t_field, field_base_t::cell_type const t_cell)
+    {
+        int count{ 0 };
+        for(int i = 0; i < t_field.height(); ++i) {
+            for(int j = 0; j < t_field.width(); ++j) {
+                count += t_field(i, j) == t_cell ? 1 : 0;
+            }
+        }
+        return count;
+    }
+
+    direction_type random_direction(unsigned& t_state)
+    {
+        t_state = t_state * 1103515245u + 12345u;
+        return static_cast<direction_type>((t_state >> 16) % 4);
+    }
+
+    // update_field() only rewrites the cells a move changes; the board
+    // must still show exactly the snake after every tick.
+    template<typename Field>
+    void check_board_follows_snake(Field const& t_empty)
+    {
+        unsigned state{ 7 };
+
+        for(int game = 0; game < 20; ++game) {
+            simulation_t<Field> simulation{ std::uint64_t(game + 1), t_empty };
+
+            while(simulation.is_running()) {
+                simulation.step(random_direction(state));
+
+                Field const& field = simulation.get_field();
+                position_t const head = simulation.get_snake().get_head_position();
+                int const length = static_cast<int>(simulation.get_length());
+
+                SNAKE_CHECK(field(head.i, head.j) == field_base_t::SNAKE_HEAD);
+                SNAKE_CHECK(count_cells(field, field_base_t::SNAKE_HEAD) == 1);
+                SNAKE_CHECK(count_cells(field, field_base_t::SNAKE_BODY) == length - 1);
+            }
+        }
+    }
+
+    // Everything a later step() can observe: cells, free-cell order (fruit
+    // draws index into it), snake ends, fruit, direction and RNG.
+    template<typename Field>
+    bool same_state(simulation_t<Field> t_a, simulation_t<Field> t_b)
+    {
+        Field const& a = t_a.get_field();
+        Field const& b = t_b.get_field();
+
+        if(a.free_cell_count() != b.free_cell_count() ||
+           t_a.get_length() != t_b.get_length() ||
+           t_a.is_running() != t_b.is_running() ||
+           t_a.get_direction() != t_b.get_direction() ||
+           t_a.get_fruit().get_slot() != t_b.get_fruit().get_slot()) {
+            return false;
+        }
+        for(int i = 0; i < a.height(); ++i) {
+            for(int j = 0; j < a.width(); ++j) {
+                if(a(i, j) != b(i, j)) {
+                    return false;
+                }
+            }
+        }
+        for(std::size_t k = 0; k < a.free_cell_count(); ++k) {
+            if(a.free_cell(k).i != b.free_cell(k).i || a.free_cell(k).j != b.free_cell(k).j) {
+                return false;
+            }
+        }
+
+        // Equal engines draw the same fruit on the next meal, so walk both
+        // copies into the same fruit-eating future.
+        for(int tick = 0; tick < 200 && t_a.is_running(); ++tick) {
+            direction_type const direction = static_cast<direction_type>(tick / 7 % 4);
+            t_a.step(direction);
+            t_b.step(direction);
+            if(t_a.get_fruit().get_position().i != t_b.get_fruit().get_position().i ||
+               t_a.get_fruit().get_position().j != t_b.get_fruit().get_position().j ||
+               t_a.get_length() != t_b.get_length()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Steps a game with undo records kept, undoing and redoing every tick
+    // on the way, then unwinds the whole game back to its start.
+    template<typename Field>
+    void check_undo(Field const& t_empty)
+    {
+        unsigned state{ 23 };
+
+        for(int game = 0; game < 10; ++game) {
+            simulation_t<Field> simulation{ std::uint64_t(game + 1), t_empty };
+            simulation_t<Field> const start = simulation;
+            std::vector<simulation_t<Field>> history;
+            std::vector<tick_undo_t> undos;
+
+            while(simulation.is_running()) {
+                direction_type const direction = random_direction(state);
+                simulation_t<Field> const before = simulation;
+
+                tick_undo_t undo{};
+                simulation.step(direction, undo);
+                simulation_t<Field> const after = simulation;
+
+                simulation.undo(undo);
+                SNAKE_CHECK(same_state(simulation, before));
+
+                simulation.redo(undo);
+                SNAKE_CHECK(same_state(simulation, after));
+
+                history.push_back(before);
+                undos.push_back(undo);
+            }
+
+            while(!undos.empty()) {
+                simulation.undo(undos.back());
+                undos.pop_back();
+                SNAKE_CHECK(same_state(simulation, history.back()));
+                history.pop_back();
+            }
+            SNAKE_CHECK(same_state(simulation, start));
+        }
+    }
+}
+
+SNAKE_TEST(simulation_starts_with_one_head_and_one_fruit)
+{
+    simulation_type simulation{ 1 };
+
+    SNAKE_CHECK(simulation.is_running());
+    SNAKE_CHECK(simulation.get_length() == 1);
+    SNAKE_CHECK(count_cells(simulation.get_field(), field_base_t::SNAKE_HEAD) == 1);
+    SNAKE_CHECK(count_cells(simulation.get_field(), field_base_t::FRUIT) == 1);
+}
+
+SNAKE_TEST(simulation_stops_at_the_wall)
+{
+    simulation_type simulation{ 1 };
+    int const rows_above = simulation.get_snake().get_head_position().i;
+
+    for(int tick = 0; tick < rows_above; ++tick) {
+        SNAKE_CHECK(simulation.step(UP));
+    }
+    SNAKE_CHECK(simulation.get_snake().get_head_position().i == 0);
+
+    SNAKE_CHECK(!simulation.step(UP));
+    SNAKE_CHECK(!simulation.is_running());
+}
+
+SNAKE_TEST(simulation_ignores_reversals)
+{
+    simulation_type simulation{ 1 };
+    int const start = simulation.get_snake().get_head_position().i;
+
+    simulation.step(UP);
+    simulation.step(DOWN);
+
+    SNAKE_CHECK(simulation.get_direction() == UP);
+    SNAKE_CHECK(simulation.get_snake().get_head_position().i == start - 2);
+}
+
+SNAKE_TEST(simulation_keeps_the_board_in_step_with_the_snake)
+{
+    check_board_follows_snake(default_game_field_t{});
+    check_board_follows_snake(dynamic_game_field_t{ dynamic_extent_t{ 37, 23 } });
+    check_board_follows_snake(packed_game_field_t{ dynamic_extent_t{ 37, 23 } });
+}
+
+SNAKE_TEST(simulation_seed_fixes_every_fruit)
+{
+    simulation_type first{ 42 };
+    simulation_type second{ 42 };
+    unsigned state{ 3 };
+
+    while(first.is_running()) {
+        auto const direction = random_direction(state);
+
+        first.step(direction);
+        second.step(direction);
+
+        SNAKE_CHECK(second.is_running() == first.is_running());
+        SNAKE_CHECK(second.get_length() == first.get_length());
+        SNAKE_CHECK(second.get_fruit().get_position().i == first.get_fruit().get_position().i);
+        SNAKE_CHECK(second.get_fruit().get_position().j == first.get_fruit().get_position().j);
+    }
+}
+
+// A run-time sized board of the default size plays the same game.
+SNAKE_TEST(simulation_on_a_dynamic_board_matches_the_fixed_one)
+{
+    simulation_type fixed{ 9 };
+    simulation_t<dynamic_game_field_t> dynamic{
+        9, dynamic_game_field_t{ dynamic_extent_t{ globals::field_width, globals::field_height } }
+    };
+    unsigned state{ 5 };
+
+    while(fixed.is_running()) {
+        auto const direction = random_direction(state);
+
+        SNAKE_CHECK(dynamic.step(direction) == fixed.step(direction));
+        SNAKE_CHECK(dynamic.get_length() == fixed.get_length());
+        SNAKE_CHECK(dynamic.get_fruit().get_position().i == fixed.get_fruit().get_position().i);
+        SNAKE_CHECK(dynamic.get_fruit().get_position().j == fixed.get_fruit().get_position().j);
+    }
+}
+
+// Copying just the cells in get_delta() onto the previous board must give
+// the new board, which is what the frontend's partial redraw relies on.
+SNAKE_TEST(simulation_delta_lists_every_changed_cell)
+{
+    unsigned state{ 17 };
+
+    for(int game = 0; game < 20; ++game) {
+        simulation_type simulation{ std::uint64_t(game + 1) };
+        default_game_field_t mirror{ simulation.get_field() };
+
+        while(simulation.is_running()) {
+            simulation.step(random_direction(state));
+
+            default_game_field_t const& field = simulation.get_field();
+            simulation.get_delta().for_each_cell([&](position_t const& t_pos) {
+                mirror.set(t_pos.i, t_pos.j, field(t_pos.i, t_pos.j));
+            });
+
+            for(int i = 0; i < field.height(); ++i) {
+                for(int j = 0; j < field.width(); ++j) {
+                    SNAKE_CHECK(mirror(i, j) == field(i, j));
+                }
+            }
+        }
+    }
+}
+
+SNAKE_TEST(simulation_undo_restores_the_state)
+{
+    check_undo(default_game_field_t{});
+    check_undo(dynamic_game_field_t{ dynamic_extent_t{ 9, 6 } });
+    check_undo(packed_game_field_t{ dynamic_extent_t{ 9, 6 } });
+}
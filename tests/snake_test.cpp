@@ -0,0 +1,64 @@
+#include "core/game_field.hpp"
+#include "core/snake.hpp"
+
+#include "test.hpp"
+
+SNAKE_TEST(snake_try_move_reports_fruit_and_collisions)
+{
+    using snake_type = snake_t<default_game_field_t>;
+
+    default_game_field_t field{};
+    snake_type snake{ field };
+    position_t const start = snake.get_head_position();
+
+    field.set(start.i - 1, start.j, field_base_t::FRUIT);
+    SNAKE_CHECK(snake.try_move(field, UP) == snake_type::ATE);
+    SNAKE_CHECK(snake.get_length() == 2);
+
+    // Straight back into the neck.
+    SNAKE_CHECK(snake.try_move(field, DOWN) == snake_type::COLLIDED);
+    SNAKE_CHECK(snake.get_length() == 2);
+
+    while(snake.get_head_position().i > 0) {
+        SNAKE_CHECK(snake.try_move(field, UP) == snake_type::MOVED);
+    }
+    SNAKE_CHECK(snake.get_length() == 2);
+
+    // A collision leaves the snake where it was.
+    SNAKE_CHECK(snake.try_move(field, UP) == snake_type::COLLIDED);
+    SNAKE_CHECK(snake.get_head_position().i == 0);
+    SNAKE_CHECK(snake.get_head_position().j == start.j);
+    SNAKE_CHECK(snake.get_length() == 2);
+}
+
+SNAKE_TEST(snake_moves_one_cell_in_every_direction)
+{
+    using snake_type = snake_t<default_game_field_t>;
+
+    direction_type const directions[] = { UP, LEFT, DOWN, DOWN, RIGHT, RIGHT, UP };
+
+    default_game_field_t field{};
+    snake_type snake{ field };
+    snake.lengthen(field, UP);
+    snake.lengthen(field, UP);
+
+    for(direction_type const direction : directions) {
+        position_t const head = snake.get_head_position();
+        position_t const tail = snake.get_tail_position();
+
+        snake.move(field, direction);
+        SNAKE_CHECK(snake.get_length() == 3);
+        SNAKE_CHECK(snake.get_head_position().i == head.i + row_step[direction]);
+        SNAKE_CHECK(snake.get_head_position().j == head.j + column_step[direction]);
+        SNAKE_CHECK(field(head.i, head.j) == field_base_t::SNAKE_BODY);
+        SNAKE_CHECK(field(tail.i, tail.j) == field_base_t::EMPTY);
+    }
+
+    // Into the neck, then off the left edge.
+    SNAKE_CHECK(!snake.try_lengthen(field, opposite(directions[6])));
+    while(snake.get_head_position().j > 0) {
+        snake.move(field, LEFT);
+    }
+    SNAKE_CHECK(!snake.try_lengthen(field, LEFT));
+    SNAKE_CHECK(snake.get_length() == 3);
+}
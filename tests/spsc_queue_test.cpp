@@ -0,0 +1,35 @@
+#include "core/spsc_queue.hpp"
+
+#include "test.hpp"
+
+SNAKE_TEST(spsc_queue_is_fifo_and_refuses_to_overwrite)
+{
+    spsc_queue_t<int, 4> queue;
+    int item{ -1 };
+
+    SNAKE_CHECK(queue.empty());
+    SNAKE_CHECK(!queue.pop(item));
+
+    // Run the indices past the capacity a few times so they wrap.
+    int next_push{ 0 };
+    int next_pop{ 0 };
+    for(int round = 0; round < 5; ++round) {
+        while(queue.push(next_push)) {
+            ++next_push;
+        }
+        SNAKE_CHECK(next_push - next_pop == static_cast<int>(queue.capacity()));
+
+        for(int k = 0; k < 3; ++k) {
+            SNAKE_CHECK(queue.pop(item));
+            SNAKE_CHECK(item == next_pop);
+            ++next_pop;
+        }
+    }
+
+    while(queue.pop(item)) {
+        SNAKE_CHECK(item == next_pop);
+        ++next_pop;
+    }
+    SNAKE_CHECK(next_pop == next_push);
+    SNAKE_CHECK(queue.empty());
+}
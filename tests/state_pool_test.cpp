@@ -0,0 +1,52 @@
+#include "core/simulation.hpp"
+#include "core/state_pool.hpp"
+
+#include "test.hpp"
+
+namespace {
+    using state_type = game_state_t<8, 6>;
+}
+
+// A clone is a separate game: stepping it leaves the original alone and
+// it plays on exactly as the original would.
+SNAKE_TEST(state_pool_clones_are_independent_games)
+{
+    state_pool_t<state_type> pool{ 2 };
+    state_type original{ 5 };
+
+    original.step(LEFT);
+    state_type* const clone = pool.clone(original);
+    SNAKE_CHECK(clone != nullptr);
+    SNAKE_CHECK(pool.size() == 1);
+
+    state_type reference = original;
+    for(int tick = 0; tick < 50 && reference.is_running(); ++tick) {
+        direction_type const direction = static_cast<direction_type>(tick / 3 % 4);
+        SNAKE_CHECK(clone->step(direction) == reference.step(direction));
+        SNAKE_CHECK(clone->get_length() == reference.get_length());
+        SNAKE_CHECK(clone->get_fruit().get_position().i == reference.get_fruit().get_position().i);
+        SNAKE_CHECK(clone->get_fruit().get_position().j == reference.get_fruit().get_position().j);
+    }
+
+    SNAKE_CHECK(original.get_length() == 1);
+    SNAKE_CHECK(original.is_running());
+}
+
+SNAKE_TEST(state_pool_hands_out_only_its_capacity)
+{
+    state_pool_t<state_type> pool{ 2 };
+    state_type const state{ 1 };
+
+    state_type* const first = pool.clone(state);
+    state_type* const second = pool.clone(state);
+    SNAKE_CHECK(first != nullptr && second != nullptr && first != second);
+    SNAKE_CHECK(pool.clone(state) == nullptr);
+
+    pool.release(first);
+    SNAKE_CHECK(pool.size() == 1);
+    SNAKE_CHECK(pool.clone(state) == first);
+
+    pool.clear();
+    SNAKE_CHECK(pool.size() == 0);
+    SNAKE_CHECK(pool.clone(state) != nullptr);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+// A small harness so the tests need nothing beyond the core: every
+// SNAKE_TEST registers itself with the main() in tests/main.cpp, and a
+// failed SNAKE_CHECK is reported without stopping the test.
+struct test_case_t
+{
+    char const* name{ nullptr };
+    void (*run)(){ nullptr };
+};
+
+std::vector<test_case_t>& test_registry();
+// Failed checks so far, over every test run.
+int& test_failures();
+
+struct test_registrar_t
+{
+    test_registrar_t(char const* t_name, void (*t_run)())
+    { test_registry().push_back({ t_name, t_run }); }
+};
+
+#define SNAKE_TEST(name)                                              \
+    static void name();                                               \
+    static test_registrar_t const name##_registrar{ #name, &name };   \
+    static void name()
+
+#define SNAKE_CHECK(condition)                                        \
+    do {                                                              \
+        if(!(condition)) {                                            \
+            std::printf("%s:%d: check failed: %s\n",                  \
+                        __FILE__, __LINE__, #condition);              \
+            ++test_failures();                                        \
+        }                                                             \
+    } while(false)
@@ -0,0 +1,38 @@
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "core/thread_pool.hpp"
+
+#include "test.hpp"
+
+SNAKE_TEST(thread_pool_runs_every_item_exactly_once)
+{
+    thread_pool_t pool{ 4 };
+    SNAKE_CHECK(pool.size() == 4);
+
+    std::size_t constexpr count{ 10007 };
+    std::vector<std::atomic<int>> visits(count);
+
+    // Several jobs in a row reuse the same workers; odd grains leave a
+    // short last chunk.
+    for(std::size_t grain : { std::size_t{ 1 }, std::size_t{ 7 }, std::size_t{ 4096 } }) {
+        for(std::atomic<int>& visit : visits) {
+            visit = 0;
+        }
+
+        pool.parallel_for(3, count, grain,
+            [&visits](std::size_t const t_begin, std::size_t const t_end) {
+                for(std::size_t index = t_begin; index < t_end; ++index) {
+                    visits[index].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        );
+
+        bool exact{ true };
+        for(std::size_t index = 0; index < count; ++index) {
+            exact = exact && visits[index] == (index < 3 ? 0 : 1);
+        }
+        SNAKE_CHECK(exact);
+    }
+}
@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "core/trajectory.hpp"
+
+#include "test.hpp"
+
+namespace {
+    using cell_type = field_base_t::cell_type;
+
+    char const* const path{ "snake_tests_trajectory.bin" };
+    char const* const other_path{ "snake_tests_trajectory_2.bin" };
+
+    // Episode k has k + 1 ticks on a (k + 2) x 3 board, every byte derived
+    // from k and the tick so the reader can check it in place.
+    struct episode_t
+    {
+        std::uint64_t seed{ 0 };
+        int width{ 0 };
+        int height{ 3 };
+        std::vector<std::uint8_t> actions;
+        std::vector<std::uint8_t> results;
+        std::vector<cell_type> states;
+    };
+
+    episode_t make_episode(std::size_t const t_k)
+    {
+        episode_t episode{};
+        episode.seed = 1000 + t_k;
+        episode.width = static_cast<int>(t_k) + 2;
+
+        std::size_t const cells = std::size_t(episode.width) * episode.height;
+        for(std::size_t tick = 0; tick <= t_k; ++tick) {
+            episode.actions.push_back(static_cast<std::uint8_t>((t_k + tick) % 4));
+            episode.results.push_back(static_cast<std::uint8_t>(tick % 3));
+            for(std::size_t cell = 0; cell < cells; ++cell) {
+                episode.states.push_back(static_cast<cell_type>((t_k + tick + cell) % 4));
+            }
+        }
+        return episode;
+    }
+
+    bool matches(episode_view_t const& t_view, episode_t const& t_episode)
+    {
+        if(t_view.header->seed != t_episode.seed ||
+           t_view.header->width != t_episode.width ||
+           t_view.header->height != t_episode.height ||
+           t_view.size() != t_episode.actions.size()) {
+            return false;
+        }
+
+        for(std::size_t tick = 0; tick < t_view.size(); ++tick) {
+            if(t_view.action(tick) != t_episode.actions[tick] ||
+               t_view.result(tick) != t_episode.results[tick]) {
+                return false;
+            }
+            for(std::size_t cell = 0; cell < t_view.cells(); ++cell) {
+                if(t_view.state(tick)[cell] != t_episode.states[tick * t_view.cells() + cell]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// Odd episodes go through begin/add/end, even ones through
+// write_episode(); three per chunk leaves the last chunk short.
+SNAKE_TEST(trajectory_round_trips_through_the_file)
+{
+    std::size_t constexpr count{ 7 };
+    std::vector<episode_t> episodes;
+
+    {
+        trajectory_writer_t writer{};
+        SNAKE_CHECK(writer.open(path, 3));
+
+        for(std::size_t k = 0; k < count; ++k) {
+            episode_t const& episode = episodes.emplace_back(make_episode(k));
+
+            if(k % 2 == 0) {
+                SNAKE_CHECK(writer.write_episode(
+                    episode.seed, episode.width, episode.height, episode.actions.size(),
+                    episode.actions.data(), episode.results.data(), episode.states.data()
+                ));
+                continue;
+            }
+
+            SNAKE_CHECK(writer.begin_episode(episode.seed, episode.width, episode.height));
+            std::size_t const cells = std::size_t(episode.width) * episode.height;
+            for(std::size_t tick = 0; tick < episode.actions.size(); ++tick) {
+                writer.add_tick(episode.states.data() + tick * cells,
+                                static_cast<direction_type>(episode.actions[tick]),
+                                static_cast<snake_base_t::move_result>(episode.results[tick]));
+            }
+            SNAKE_CHECK(writer.end_episode());
+        }
+
+        SNAKE_CHECK(writer.finish());
+    }
+
+    trajectory_reader_t reader{};
+    SNAKE_CHECK(reader.open(path));
+    SNAKE_CHECK(reader.episode_count() == count);
+
+    episode_view_t view{};
+    for(std::size_t k = count; k-- > 0;) {
+        SNAKE_CHECK(reader.episode(k, view) && matches(view, episodes[k]));
+    }
+    SNAKE_CHECK(!reader.episode(count, view));
+
+    trajectory_reader_t::cursor_t cursor = reader.cursor(2);
+    std::size_t k{ 2 };
+    while(cursor.next(view)) {
+        SNAKE_CHECK(k < count && matches(view, episodes[k]));
+        ++k;
+    }
+    SNAKE_CHECK(k == count);
+
+    std::remove(path);
+}
+
+// Board sides go into 16-bit header fields; larger ones must be refused,
+// not truncated, and leave the file readable.
+SNAKE_TEST(trajectory_writer_rejects_boards_the_header_cannot_hold)
+{
+    episode_t const episode = make_episode(1);
+
+    {
+        trajectory_writer_t writer{};
+        SNAKE_CHECK(writer.open(path));
+
+        SNAKE_CHECK(!writer.begin_episode(1, 65536, 2));
+        writer.add_tick(episode.states.data(), UP, snake_base_t::MOVED);
+        SNAKE_CHECK(!writer.end_episode());
+
+        SNAKE_CHECK(!writer.begin_episode(1, 2, 0));
+        SNAKE_CHECK(!writer.end_episode());
+
+        SNAKE_CHECK(!writer.write_episode(
+            1, 3, 70000, episode.actions.size(),
+            episode.actions.data(), episode.results.data(), episode.states.data()
+        ));
+
+        SNAKE_CHECK(writer.write_episode(
+            episode.seed, episode.width, episode.height, episode.actions.size(),
+            episode.actions.data(), episode.results.data(), episode.states.data()
+        ));
+        SNAKE_CHECK(writer.finish());
+    }
+
+    trajectory_reader_t reader{};
+    episode_view_t view{};
+    SNAKE_CHECK(reader.open(path));
+    SNAKE_CHECK(reader.episode_count() == 1);
+    SNAKE_CHECK(reader.episode(0, view) && matches(view, episode));
+
+    std::remove(path);
+}
+
+// Reopening finishes the first file instead of leaking it unterminated.
+SNAKE_TEST(trajectory_writer_finishes_a_file_it_reopens_over)
+{
+    episode_t const episode = make_episode(2);
+
+    trajectory_writer_t writer{};
+    SNAKE_CHECK(writer.open(path));
+    SNAKE_CHECK(writer.write_episode(
+        episode.seed, episode.width, episode.height, episode.actions.size(),
+        episode.actions.data(), episode.results.data(), episode.states.data()
+    ));
+    SNAKE_CHECK(writer.open(other_path));
+    SNAKE_CHECK(writer.finish());
+
+    trajectory_reader_t first{};
+    trajectory_reader_t second{};
+    SNAKE_CHECK(first.open(path) && first.episode_count() == 1);
+    SNAKE_CHECK(second.open(other_path) && second.episode_count() == 0);
+
+    std::remove(path);
+    std::remove(other_path);
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "core/batch_simulation.hpp"
+#include "core/position.hpp"
+#include "core/random.hpp"
+#include "core/trajectory.hpp"
+
+// Writes trajectory datasets from the batch engine and reads them back:
+//   snake_dataset write <file> <episodes> [--games <n>] [--seed <s>]
+//   snake_dataset read <file> [<first episode>]
+// The writer plays a random policy that never reverses; the reader walks
+// the episodes from <first episode> on and prints totals.
+namespace {
+    int constexpr board_size{ 10 };
+    using batch_type = batch_simulation_t<board_size, board_size>;
+
+    struct pending_episode_t
+    {
+        std::vector<std::uint8_t> actions;
+        std::vector<std::uint8_t> results;
+        std::vector<field_base_t::cell_type> states;
+    };
+
+    int write_dataset(char const* t_path, std::size_t const t_episodes,
+                      std::size_t const t_games, std::uint64_t const t_seed)
+    {
+        trajectory_writer_t writer{};
+        if(!writer.open(t_path)) {
+            std::fprintf(stderr, "Can't write %s\n", t_path);
+            return EXIT_FAILURE;
+        }
+
+        batch_type batch{ t_games, t_seed };
+        std::vector<direction_type> directions(t_games);
+        std::vector<pending_episode_t> pending(t_games);
+        std::vector<std::uint64_t> seeds(t_games);
+        rng_engine_t policy{ t_seed };
+        std::size_t written{ 0 };
+
+        while(written < t_episodes) {
+            for(std::size_t game = 0; game < t_games; ++game) {
+                auto turn = static_cast<direction_type>(random_below(policy, 4));
+                if(turn == opposite(batch.get_direction(game))) {
+                    turn = batch.get_direction(game);
+                }
+                directions[game] = turn;
+
+                auto& episode = pending[game];
+                episode.actions.push_back(static_cast<std::uint8_t>(turn));
+                episode.states.insert(
+                    episode.states.end(), batch.get_cells(game),
+                    batch.get_cells(game) + batch.cell_count()
+                );
+            }
+
+            for(std::size_t game = 0; game < t_games; ++game) {
+                seeds[game] = batch.get_seed(game);
+            }
+
+            batch.step(directions.data());
+
+            for(std::size_t game = 0; game < t_games && written < t_episodes; ++game) {
+                auto& episode = pending[game];
+                episode.results.push_back(static_cast<std::uint8_t>(batch.get_result(game)));
+
+                if(!batch.get_done(game)) {
+                    continue;
+                }
+
+                if(!writer.write_episode(seeds[game], board_size, board_size,
+                                         episode.actions.size(), episode.actions.data(),
+                                         episode.results.data(), episode.states.data())) {
+                    std::fprintf(stderr, "Can't write %s\n", t_path);
+                    return EXIT_FAILURE;
+                }
+                ++written;
+
+                episode.actions.clear();
+                episode.results.clear();
+                episode.states.clear();
+            }
+        }
+
+        if(!writer.finish()) {
+            std::fprintf(stderr, "Can't write %s\n", t_path);
+            return EXIT_FAILURE;
+        }
+
+        std::printf("Episodes: %zu\n", written);
+        return EXIT_SUCCESS;
+    }
+
+    int read_dataset(char const* t_path, std::size_t const t_first)
+    {
+        trajectory_reader_t reader{};
+        if(!reader.open(t_path)) {
+            std::fprintf(stderr, "Can't read %s\n", t_path);
+            return EXIT_FAILURE;
+        }
+        if(t_first > reader.episode_count()) {
+            std::fprintf(stderr, "First episode %zu is past the %zu in %s\n",
+                         t_first, reader.episode_count(), t_path);
+            return EXIT_FAILURE;
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+
+        auto cursor = reader.cursor(t_first);
+        episode_view_t episode{};
+        std::size_t episodes{ 0 };
+        std::uint64_t ticks{ 0 };
+        std::int64_t reward{ 0 };
+        std::uint64_t snake_cells{ 0 };
+
+        while(cursor.next(episode)) {
+            ++episodes;
+            ticks += episode.size();
+
+            for(std::size_t tick = 0; tick < episode.size(); ++tick) {
+                reward += episode.reward(tick);
+            }
+            if(episode.size() > 0) {
+                auto const* last = episode.state(episode.size() - 1);
+                for(std::size_t cell = 0; cell < episode.cells(); ++cell) {
+                    snake_cells += (last[cell] & field_base_t::SNAKE_MASK) != 0;
+                }
+            }
+        }
+
+        std::chrono::duration<double> const elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        if(t_first + episodes != reader.episode_count()) {
+            std::fprintf(stderr, "Malformed episode after %zu\n", t_first + episodes);
+            return EXIT_FAILURE;
+        }
+
+        std::printf("Episodes: %zu of %zu\nTicks: %llu\nReward: %lld\n"
+                    "Snake cells on last boards: %llu\nElapsed: %.6f s\n",
+                    episodes, reader.episode_count(),
+                    static_cast<unsigned long long>(ticks),
+                    static_cast<long long>(reward),
+                    static_cast<unsigned long long>(snake_cells),
+                    elapsed.count());
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc >= 4 && std::strcmp(argv[1], "write") == 0) {
+        std::size_t games{ 256 };
+        std::uint64_t seed{ 1 };
+
+        for(int k = 4; k + 1 < argc; ++k) {
+            if(std::strcmp(argv[k], "--games") == 0) {
+                games = std::max(1ull, std::strtoull(argv[++k], nullptr, 10));
+            }
+            else if(std::strcmp(argv[k], "--seed") == 0) {
+                seed = std::strtoull(argv[++k], nullptr, 10);
+            }
+        }
+
+        return write_dataset(argv[2], std::strtoull(argv[3], nullptr, 10), games, seed);
+    }
+    if(argc >= 3 && std::strcmp(argv[1], "read") == 0) {
+        std::size_t const first = argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 0;
+        return read_dataset(argv[2], first);
+    }
+
+    std::fprintf(stderr,
+                 "usage: %s write <file> <episodes> [--games <n>] [--seed <s>]\n"
+                 "       %s read <file> [<first episode>]\n", argv[0], argv[0]);
+    return EXIT_FAILURE;
+}
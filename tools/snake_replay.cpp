@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "core/game_field.hpp"
+#include "core/mapped_file.hpp"
+#include "core/replay.hpp"
+#include "core/simulation.hpp"
+
+// Plays a replay recorded by `ioana --record` without a window, either as
+// fast as possible or, with --realtime <ms>, one tick every <ms>
+// milliseconds, and prints how the game ended.
+int main(int argc, char** argv)
+{
+    if(argc < 2) {
+        std::fprintf(stderr, "usage: %s <replay> [--realtime <ms per tick>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int tick_ms{ 0 };
+    for(int k = 2; k + 1 < argc; ++k) {
+        if(std::strcmp(argv[k], "--realtime") == 0) {
+            tick_ms = std::atoi(argv[++k]);
+        }
+    }
+
+    mapped_file_t file{};
+    if(!file.open(argv[1])) {
+        std::fprintf(stderr, "Can't read replay %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    replay_t replay{};
+    if(replay_t::decode(file.data(), file.size(), replay) == 0) {
+        std::fprintf(stderr,
+                     "%s is not a valid version %d replay: it is truncated, or its "
+                     "board is outside 2x2 to %dx%d or over %zu cells\n",
+                     argv[1], int(replay_t::version), replay_t::max_side,
+                     replay_t::max_side, replay_t::max_cells);
+        return EXIT_FAILURE;
+    }
+
+    simulation_t<dynamic_game_field_t> simulation{
+        replay.seed,
+        dynamic_game_field_t{ dynamic_extent_t{ replay.width, replay.height } }
+    };
+    replay_player_t player{ replay };
+
+    auto const start = std::chrono::steady_clock::now();
+    auto due = start;
+
+    while(!player.done() && simulation.step(player.next())) {
+        if(tick_ms > 0) {
+            due += std::chrono::milliseconds{ tick_ms };
+            std::this_thread::sleep_until(due);
+        }
+    }
+
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::printf("Seed: %llu\nBoard: %dx%d\nTicks: %llu of %llu\nScore: %zu\n",
+                static_cast<unsigned long long>(replay.seed),
+                replay.width, replay.height,
+                static_cast<unsigned long long>(player.get_tick()),
+                static_cast<unsigned long long>(replay.tick_count),
+                simulation.get_length());
+    std::printf("Elapsed: %.6f s (%.0f ticks/s)\n", elapsed.count(),
+                elapsed.count() > 0.0 ? player.get_tick() / elapsed.count() : 0.0);
+
+    return EXIT_SUCCESS;
+}
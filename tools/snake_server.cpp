@@ -0,0 +1,542 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "core/arena.hpp"
+#include "core/arena_stream.hpp"
+#include "core/random.hpp"
+#include "core/thread_pool.hpp"
+#include "core/trace.hpp"
+
+// Runs an arena and streams it to every spectator that connects:
+//   snake_server [--port <p>] [--width <w>] [--height <h>] [--snakes <n>]
+//                [--fruits <n>] [--tick-ms <ms>] [--threads <n>]
+//                [--ticks <n>] [--seed <s>] [--trace <file.json>]
+// The server is authoritative and steers every snake itself. A spectator
+// gets a snapshot when it connects and then one tick frame per tick (see
+// arena_stream.hpp); every frame is encoded once and shared by all the
+// queues it sits in. One thread does all the I/O: sockets are
+// non-blocking, epoll only watches a socket for writability while its
+// queue is backed up, and a flush hands the whole queue to one sendmsg().
+// A spectator whose backlog grows past max_backlog loses it and is sent a
+// fresh snapshot instead. Whatever a spectator sends is read and dropped.
+namespace {
+    using frame_ptr = std::shared_ptr<std::vector<std::uint8_t> const>;
+
+    std::size_t constexpr max_backlog{ std::size_t{ 1 } << 20 };
+    std::size_t constexpr max_iovecs{ 64 };
+    int constexpr max_events{ 256 };
+    // How long the listener is left alone after accept() failed for want
+    // of file descriptors.
+    std::chrono::milliseconds constexpr accept_pause{ 1000 };
+    // Tick frames carrying a checksum, for spectators to verify their copy.
+    std::uint64_t constexpr checksum_interval{ 64 };
+
+    volatile std::sig_atomic_t g_stop{ 0 };
+
+    void on_signal(int)
+    { g_stop = 1; }
+
+    // epoll data for a descriptor: the fd in the low half and, for a
+    // spectator, its connection number in the high half. An fd dropped
+    // while handling one batch of events can be handed out again by an
+    // accept() in the same batch; the number tells the new connection's
+    // events from the stale ones still queued for the old. The listener
+    // uses number 0.
+    constexpr std::uint64_t event_key(int const t_fd, std::uint32_t const t_connection) noexcept
+    { return std::uint64_t{ t_connection } << 32 | static_cast<std::uint32_t>(t_fd); }
+
+    struct server_options_t
+    {
+        int port{ 7777 };
+        arena_options_t arena{};
+        int tick_ms{ 50 };
+        std::size_t threads{ 0 };
+        // 0 runs until SIGINT or SIGTERM.
+        std::uint64_t ticks{ 0 };
+        char const* trace_path{ nullptr };
+    };
+
+    struct spectator_t
+    {
+        int fd{ -1 };
+        std::uint32_t connection{ 0 };
+        std::deque<frame_ptr> queue;
+        // Bytes of queue.front() already sent.
+        std::size_t offset{ 0 };
+        std::size_t backlog{ 0 };
+        bool watching_output{ false };
+    };
+
+    struct server_t
+    {
+        server_options_t const& options;
+        arena_simulation_t arena;
+        std::unique_ptr<thread_pool_t> pool;
+        rng_engine_t policy;
+        std::vector<direction_type> directions;
+
+        int listener{ -1 };
+        int poller{ -1 };
+        // While set, the listener is out of the poller until accept_resume.
+        bool accept_paused{ false };
+        std::chrono::steady_clock::time_point accept_resume{};
+        std::unordered_map<int, spectator_t> spectators;
+        std::uint32_t connections{ 0 };
+
+        std::uint64_t tick{ 0 };
+        frame_ptr snapshot;
+        std::uint64_t snapshot_tick{ 0 };
+
+        std::uint64_t bytes_sent{ 0 };
+        std::uint64_t tick_bytes{ 0 };
+        std::uint64_t resyncs{ 0 };
+        std::size_t peak_spectators{ 0 };
+
+        explicit server_t(server_options_t const& t_options)
+            : options{ t_options }
+            , arena{ t_options.arena }
+            , policy{ t_options.arena.seed + 1 }
+            , directions(t_options.arena.snakes, UP)
+        {
+            if(t_options.threads > 0) {
+                pool = std::make_unique<thread_pool_t>(t_options.threads);
+            }
+        }
+
+        ~server_t() noexcept
+        {
+            for(auto const& entry : spectators) {
+                ::close(entry.first);
+            }
+            if(poller >= 0) {
+                ::close(poller);
+            }
+            if(listener >= 0) {
+                ::close(listener);
+            }
+        }
+
+        bool listen()
+        {
+            listener = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if(listener < 0) {
+                return false;
+            }
+
+            int const on{ 1 };
+            ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+            address.sin_port = htons(static_cast<std::uint16_t>(options.port));
+
+            if(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+               ::listen(listener, SOMAXCONN) != 0) {
+                return false;
+            }
+
+            poller = ::epoll_create1(EPOLL_CLOEXEC);
+            if(poller < 0) {
+                return false;
+            }
+
+            return this->watch_listener();
+        }
+
+        bool watch_listener()
+        {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = event_key(listener, 0);
+            return ::epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event) == 0;
+        }
+
+        // Keeps going straight unless that runs into something, with the
+        // odd random turn so the board doesn't settle into loops.
+        void steer()
+        {
+            auto const& field = arena.get_field();
+
+            for(std::size_t snake = 0; snake < arena.size(); ++snake) {
+                if(!arena.is_alive(snake)) {
+                    continue;
+                }
+
+                direction_type const current = arena.get_direction(snake);
+                position_t const head = arena.get_head(snake);
+                direction_type choice = current;
+
+                if(random_below(policy, 16) == 0) {
+                    choice = static_cast<direction_type>(random_below(policy, 4));
+                }
+
+                for(int attempt = 0; attempt < 4; ++attempt) {
+                    position_t const next = neighbour(head, choice);
+                    if(choice != opposite(current) &&
+                       (field.at(next.i, next.j) & (field_base_t::SNAKE_MASK | field_base_t::ERROR)) == 0) {
+                        break;
+                    }
+                    choice = static_cast<direction_type>((choice + 1) % 4);
+                }
+
+                directions[snake] = choice;
+            }
+        }
+
+        frame_ptr current_snapshot()
+        {
+            if(!snapshot || snapshot_tick != tick) {
+                auto frame = std::make_shared<std::vector<std::uint8_t>>();
+                encode_arena_snapshot(arena, tick, *frame);
+                snapshot = std::move(frame);
+                snapshot_tick = tick;
+            }
+            return snapshot;
+        }
+
+        void watch_output(spectator_t& t_spectator, bool const t_watch)
+        {
+            if(t_spectator.watching_output == t_watch) {
+                return;
+            }
+
+            epoll_event event{};
+            event.events = EPOLLIN | (t_watch ? EPOLLOUT : 0u);
+            event.data.u64 = event_key(t_spectator.fd, t_spectator.connection);
+            ::epoll_ctl(poller, EPOLL_CTL_MOD, t_spectator.fd, &event);
+            t_spectator.watching_output = t_watch;
+        }
+
+        void drop(int const t_fd)
+        {
+            ::epoll_ctl(poller, EPOLL_CTL_DEL, t_fd, nullptr);
+            ::close(t_fd);
+            spectators.erase(t_fd);
+        }
+
+        // Sends as much of the queue as the socket takes; false if the
+        // spectator is gone.
+        bool flush(spectator_t& t_spectator)
+        {
+            SNAKE_TRACE_ZONE("snake_server::flush");
+
+            while(!t_spectator.queue.empty()) {
+                iovec vectors[max_iovecs];
+                std::size_t count{ 0 };
+
+                for(auto it = t_spectator.queue.begin();
+                    it != t_spectator.queue.end() && count < max_iovecs; ++it, ++count) {
+                    std::size_t const skip = count == 0 ? t_spectator.offset : 0;
+                    vectors[count].iov_base = const_cast<std::uint8_t*>((*it)->data() + skip);
+                    vectors[count].iov_len = (*it)->size() - skip;
+                }
+
+                msghdr message{};
+                message.msg_iov = vectors;
+                message.msg_iovlen = count;
+
+                ssize_t const sent = ::sendmsg(t_spectator.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+                if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if(sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                if(sent <= 0) {
+                    return false;
+                }
+
+                bytes_sent += static_cast<std::uint64_t>(sent);
+                t_spectator.backlog -= static_cast<std::size_t>(sent);
+
+                auto left = static_cast<std::size_t>(sent);
+                while(left > 0) {
+                    std::size_t const rest = t_spectator.queue.front()->size() - t_spectator.offset;
+                    if(left < rest) {
+                        t_spectator.offset += left;
+                        break;
+                    }
+
+                    left -= rest;
+                    t_spectator.offset = 0;
+                    t_spectator.queue.pop_front();
+                }
+            }
+
+            this->watch_output(t_spectator, !t_spectator.queue.empty());
+            return true;
+        }
+
+        void enqueue(spectator_t& t_spectator, frame_ptr const& t_frame)
+        {
+            t_spectator.backlog += t_frame->size();
+            t_spectator.queue.push_back(t_frame);
+        }
+
+        void accept_all()
+        {
+            SNAKE_TRACE_ZONE("snake_server::accept");
+
+            for(;;) {
+                int const fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if(fd < 0) {
+                    if(errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+                        continue;
+                    }
+                    if(errno != EAGAIN && errno != EWOULDBLOCK) {
+                        // The connection stays queued, so the listener
+                        // would wake epoll_wait again at once (EMFILE,
+                        // ENFILE, ENOBUFS...): stop polling it for a while
+                        // instead of spinning.
+                        std::fprintf(stderr, "Can't accept spectators: %s; retrying in %lld ms\n",
+                                     std::strerror(errno),
+                                     static_cast<long long>(accept_pause.count()));
+                        ::epoll_ctl(poller, EPOLL_CTL_DEL, listener, nullptr);
+                        accept_paused = true;
+                        accept_resume = std::chrono::steady_clock::now() + accept_pause;
+                    }
+                    return;
+                }
+
+                int const on{ 1 };
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+                // Never 0, which is the listener's.
+                if(++connections == 0) {
+                    connections = 1;
+                }
+
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.u64 = event_key(fd, connections);
+                if(::epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event) != 0) {
+                    ::close(fd);
+                    continue;
+                }
+
+                spectator_t& spectator = spectators[fd];
+                spectator.fd = fd;
+                spectator.connection = connections;
+                this->enqueue(spectator, this->current_snapshot());
+                if(!this->flush(spectator)) {
+                    this->drop(fd);
+                }
+                peak_spectators = std::max(peak_spectators, spectators.size());
+            }
+        }
+
+        // Reads and drops whatever the spectator sent; false once it hung up.
+        bool drain(int const t_fd)
+        {
+            std::uint8_t buffer[4096];
+
+            for(;;) {
+                ssize_t const got = ::recv(t_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+                if(got > 0) {
+                    continue;
+                }
+                return got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+            }
+        }
+
+        void step()
+        {
+            SNAKE_TRACE_ZONE("snake_server::tick");
+
+            this->steer();
+            if(pool) {
+                arena.step(directions.data(), *pool);
+            }
+            else {
+                arena.step(directions.data());
+            }
+            ++tick;
+
+            auto frame = std::make_shared<std::vector<std::uint8_t>>();
+            {
+                SNAKE_TRACE_ZONE("snake_server::encode");
+                encode_arena_tick(arena, tick, tick % checksum_interval == 0, *frame);
+            }
+            tick_bytes += frame->size();
+            frame_ptr const shared{ std::move(frame) };
+
+            std::vector<int> gone;
+            for(auto& entry : spectators) {
+                spectator_t& spectator = entry.second;
+
+                if(spectator.backlog > max_backlog) {
+                    // Keep only a frame that is partly out already.
+                    while(spectator.queue.size() > (spectator.offset > 0 ? 1u : 0u)) {
+                        spectator.backlog -= spectator.queue.back()->size();
+                        spectator.queue.pop_back();
+                    }
+                    this->enqueue(spectator, this->current_snapshot());
+                    ++resyncs;
+                }
+                else {
+                    this->enqueue(spectator, shared);
+                }
+
+                if(!this->flush(spectator)) {
+                    gone.push_back(entry.first);
+                }
+            }
+
+            for(int const fd : gone) {
+                this->drop(fd);
+            }
+        }
+
+        void run()
+        {
+            using clock = std::chrono::steady_clock;
+
+            auto const interval = std::chrono::milliseconds{ options.tick_ms };
+            auto next_tick = clock::now() + interval;
+            epoll_event events[max_events];
+
+            while(g_stop == 0 && (options.ticks == 0 || tick < options.ticks)) {
+                if(accept_paused && clock::now() >= accept_resume) {
+                    accept_paused = !this->watch_listener();
+                    if(accept_paused) {
+                        accept_resume = clock::now() + accept_pause;
+                    }
+                    else {
+                        this->accept_all();
+                    }
+                }
+
+                auto const wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    next_tick - clock::now()
+                ).count();
+                int const ready = ::epoll_wait(poller, events, max_events,
+                                               static_cast<int>(std::max<long long>(0, wait)));
+
+                for(int k = 0; k < ready; ++k) {
+                    auto const fd = static_cast<int>(events[k].data.u64 & 0xFFFFFFFFu);
+                    auto const connection = static_cast<std::uint32_t>(events[k].data.u64 >> 32);
+
+                    if(connection == 0) {
+                        this->accept_all();
+                        continue;
+                    }
+
+                    // Gone, or its fd now belongs to a newer connection.
+                    auto it = spectators.find(fd);
+                    if(it == spectators.end() || it->second.connection != connection) {
+                        continue;
+                    }
+
+                    bool alive = (events[k].events & (EPOLLERR | EPOLLHUP)) == 0;
+                    if(alive && (events[k].events & EPOLLIN) != 0) {
+                        alive = this->drain(fd);
+                    }
+                    if(alive && (events[k].events & EPOLLOUT) != 0) {
+                        alive = this->flush(it->second);
+                    }
+                    if(!alive) {
+                        this->drop(fd);
+                    }
+                }
+
+                if(clock::now() >= next_tick) {
+                    this->step();
+                    next_tick += interval;
+                }
+            }
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    server_options_t options{};
+
+    for(int k = 1; k + 1 < argc; ++k) {
+        char const* value = argv[k + 1];
+
+        if(std::strcmp(argv[k], "--port") == 0) {
+            options.port = std::atoi(value);
+        }
+        else if(std::strcmp(argv[k], "--width") == 0) {
+            options.arena.width = std::max(1, std::atoi(value));
+        }
+        else if(std::strcmp(argv[k], "--height") == 0) {
+            options.arena.height = std::max(1, std::atoi(value));
+        }
+        else if(std::strcmp(argv[k], "--snakes") == 0) {
+            options.arena.snakes = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(argv[k], "--fruits") == 0) {
+            options.arena.fruits = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(argv[k], "--tick-ms") == 0) {
+            options.tick_ms = std::max(1, std::atoi(value));
+        }
+        else if(std::strcmp(argv[k], "--threads") == 0) {
+            options.threads = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(argv[k], "--ticks") == 0) {
+            options.ticks = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(argv[k], "--seed") == 0) {
+            options.arena.seed = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(argv[k], "--trace") == 0) {
+            options.trace_path = value;
+        }
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--port <p>] [--width <w>] [--height <h>] [--snakes <n>]\n"
+                         "          [--fruits <n>] [--tick-ms <ms>] [--threads <n>]\n"
+                         "          [--ticks <n>] [--seed <s>] [--trace <file.json>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        ++k;
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    server_t server{ options };
+    if(!server.listen()) {
+        std::fprintf(stderr, "Can't listen on port %d: %s\n", options.port, std::strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Listening on port %d\n", options.port);
+    std::fflush(stdout);
+    server.run();
+
+    std::printf("Ticks: %llu\nPeak spectators: %zu\nBytes sent: %llu\n"
+                "Tick frame bytes: %.1f on average\nResyncs: %llu\n",
+                static_cast<unsigned long long>(server.tick), server.peak_spectators,
+                static_cast<unsigned long long>(server.bytes_sent),
+                server.tick > 0 ? double(server.tick_bytes) / server.tick : 0.0,
+                static_cast<unsigned long long>(server.resyncs));
+
+    if(options.trace_path != nullptr && !trace_write_chrome(options.trace_path)) {
+        std::fprintf(stderr, "Can't write %s (trace zones need -DSNAKE_TRACE=CHROME)\n",
+                     options.trace_path);
+    }
+    return EXIT_SUCCESS;
+}
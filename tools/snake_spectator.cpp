@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "core/arena_stream.hpp"
+#include "core/trace.hpp"
+
+// Connects spectators to snake_server and reports what they received:
+//   snake_spectator [--host <ipv4>] [--port <p>] [--clients <n>]
+//                   [--seconds <s>] [--fps <f>]
+// The first connection keeps an arena_view_t, checks it against the
+// server's checksums and "renders" at --fps by interpolating every head
+// and tail between the last two ticks; the others only split their
+// stream into frames, as a load test for the server.
+namespace {
+    int constexpr max_events{ 256 };
+
+    struct connection_t
+    {
+        int fd{ -1 };
+        std::vector<std::uint8_t> input;
+        std::uint64_t bytes{ 0 };
+        std::uint64_t frames{ 0 };
+        bool open{ true };
+    };
+
+    struct spectator_options_t
+    {
+        char const* host{ "127.0.0.1" };
+        int port{ 7777 };
+        std::size_t clients{ 1 };
+        double seconds{ 10.0 };
+        double fps{ 60.0 };
+    };
+
+    int connect_to(spectator_options_t const& t_options)
+    {
+        int const fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0) {
+            return -1;
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<std::uint16_t>(t_options.port));
+
+        if(::inet_pton(AF_INET, t_options.host, &address.sin_addr) != 1 ||
+           ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using clock = std::chrono::steady_clock;
+
+    spectator_options_t options{};
+
+    for(int k = 1; k + 1 < argc; ++k) {
+        char const* value = argv[k + 1];
+
+        if(std::strcmp(argv[k], "--host") == 0) {
+            options.host = value;
+        }
+        else if(std::strcmp(argv[k], "--port") == 0) {
+            options.port = std::atoi(value);
+        }
+        else if(std::strcmp(argv[k], "--clients") == 0) {
+            options.clients = std::max(1ull, std::strtoull(value, nullptr, 10));
+        }
+        else if(std::strcmp(argv[k], "--seconds") == 0) {
+            options.seconds = std::atof(value);
+        }
+        else if(std::strcmp(argv[k], "--fps") == 0) {
+            options.fps = std::max(1.0, std::atof(value));
+        }
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--host <ipv4>] [--port <p>] [--clients <n>]\n"
+                         "          [--seconds <s>] [--fps <f>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        ++k;
+    }
+
+    int const poller = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<connection_t> connections(options.clients);
+
+    for(std::size_t client = 0; client < connections.size(); ++client) {
+        int const fd = connect_to(options);
+        if(fd < 0) {
+            std::fprintf(stderr, "Can't connect to %s:%d: %s\n", options.host, options.port,
+                         std::strerror(errno));
+            return EXIT_FAILURE;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = client;
+        ::epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event);
+        connections[client].fd = fd;
+    }
+
+    arena_view_t view{};
+    std::uint64_t applied{ 0 };
+    std::uint64_t desyncs{ 0 };
+    std::uint64_t rendered{ 0 };
+    // Keeps the interpolation from being optimised away.
+    volatile double drawn{ 0.0 };
+
+    // How far the view is drawn between its last two ticks is the time
+    // since the last tick frame over the (smoothed) time between them.
+    auto last_tick = clock::now();
+    double interval{ 0.05 };
+
+    auto const start = clock::now();
+    auto const stop = start + std::chrono::duration<double>{ options.seconds };
+    auto const frame_time = std::chrono::duration<double>{ 1.0 / options.fps };
+    auto next_frame = start;
+    epoll_event events[max_events];
+
+    while(clock::now() < stop) {
+        auto const wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            next_frame - clock::now()
+        ).count();
+        int const ready = ::epoll_wait(poller, events, max_events,
+                                       static_cast<int>(std::max<long long>(0, wait)));
+
+        for(int k = 0; k < ready; ++k) {
+            auto const client = static_cast<std::size_t>(events[k].data.u64);
+            connection_t& connection = connections[client];
+            std::uint8_t buffer[65536];
+
+            ssize_t const got = ::recv(connection.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if(got <= 0) {
+                if(got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    ::epoll_ctl(poller, EPOLL_CTL_DEL, connection.fd, nullptr);
+                    connection.open = false;
+                }
+                continue;
+            }
+
+            connection.bytes += static_cast<std::uint64_t>(got);
+            connection.input.insert(connection.input.end(), buffer, buffer + got);
+
+            std::size_t used{ 0 };
+            std::size_t payload{ 0 };
+            while(peek_arena_frame(connection.input.data() + used,
+                                   connection.input.size() - used, payload) &&
+                  connection.input.size() - used >= arena_frame_header_size + payload) {
+                std::uint8_t const* frame = connection.input.data() + used + arena_frame_header_size;
+                used += arena_frame_header_size + payload;
+                ++connection.frames;
+
+                if(client != 0) {
+                    continue;
+                }
+
+                SNAKE_TRACE_ZONE("snake_spectator::apply");
+                bool const was_synced = view.synced();
+                if(view.apply(frame, payload)) {
+                    ++applied;
+
+                    auto const now = clock::now();
+                    double const seen = std::chrono::duration<double>{ now - last_tick }.count();
+                    interval += (std::min(seen, 1.0) - interval) / 16.0;
+                    last_tick = now;
+                }
+                else if(was_synced) {
+                    ++desyncs;
+                }
+            }
+            connection.input.erase(connection.input.begin(),
+                                   connection.input.begin() + static_cast<std::ptrdiff_t>(used));
+        }
+
+        auto const now = clock::now();
+        if(now < next_frame) {
+            continue;
+        }
+        next_frame += std::chrono::duration_cast<clock::duration>(frame_time);
+
+        if(view.synced()) {
+            double const alpha = std::min(
+                1.0, std::chrono::duration<double>{ now - last_tick }.count() / interval
+            );
+
+            for(std::size_t snake = 0; snake < view.size(); ++snake) {
+                if(view.is_alive(snake)) {
+                    auto const head = view.head_at(snake, alpha);
+                    auto const tail = view.tail_at(snake, alpha);
+                    drawn = drawn + head.i + head.j - tail.i - tail.j;
+                }
+            }
+            ++rendered;
+        }
+    }
+
+    std::uint64_t bytes{ 0 };
+    std::uint64_t frames{ 0 };
+    std::size_t open{ 0 };
+    for(connection_t const& connection : connections) {
+        bytes += connection.bytes;
+        frames += connection.frames;
+        open += connection.open;
+        ::close(connection.fd);
+    }
+    ::close(poller);
+
+    double const elapsed = std::chrono::duration<double>{ clock::now() - start }.count();
+    std::printf("Clients: %zu (%zu still open)\nTick: %llu\nFrames: %llu\n"
+                "Bytes: %llu (%.1f KiB/s per client)\nApplied: %llu\nDesyncs: %llu\n"
+                "Rendered: %llu frames\n",
+                connections.size(), open, static_cast<unsigned long long>(view.tick()),
+                static_cast<unsigned long long>(frames), static_cast<unsigned long long>(bytes),
+                double(bytes) / connections.size() / 1024.0 / elapsed,
+                static_cast<unsigned long long>(applied),
+                static_cast<unsigned long long>(desyncs),
+                static_cast<unsigned long long>(rendered));
+    return desyncs == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}